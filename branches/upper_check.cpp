@@ -1,4 +1,5 @@
 #include <benchmark/benchmark.h>
+#include "perf_counters.h"
 
 #include <cstdint>
 #include <limits>
@@ -77,32 +78,41 @@ inline uint32_t get_upper_uint64_t(uint32_t x)
 
 static void BM_Branch(benchmark::State& state)
 {
+    PerfCounters perf;
     size_t idx = 0;
     const size_t size = gRandomData.size();
+    perf.start();
     for (auto _ : state) {
         benchmark::DoNotOptimize(get_upper_branch(gRandomData[idx]));
         idx = (idx + 1) % size;
     }
+    perf.stop(state);
 }
 
 static void BM_Branchless(benchmark::State& state)
 {
+    PerfCounters perf;
     size_t idx = 0;
     const size_t size = gRandomData.size();
+    perf.start();
     for (auto _ : state) {
         benchmark::DoNotOptimize(get_upper_branchless(gRandomData[idx]));
         idx = (idx + 1) % size;
     }
+    perf.stop(state);
 }
 
 static void BM_CastUint64(benchmark::State& state)
 {
+    PerfCounters perf;
     size_t idx = 0;
     const size_t size = gRandomData.size();
+    perf.start();
     for (auto _ : state) {
         benchmark::DoNotOptimize(get_upper_uint64_t(gRandomData[idx]));
         idx = (idx + 1) % size;
     }
+    perf.stop(state);
 }
 
 // Register the benchmarks
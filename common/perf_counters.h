@@ -0,0 +1,159 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ----------------------------------------------------
+// Hardware performance counters for Google Benchmark
+// ----------------------------------------------------
+//
+//   static void BM_Something(benchmark::State& state) {
+//       PerfCounters perf;      // before any threads the benchmark starts
+//       ... setup ...
+//       perf.start();
+//       for (auto _ : state) { ... }
+//       perf.stop(state);       // adds the counters to state.counters
+//   }
+//
+// Reported per iteration: cycles, instructions, IPC, L1D_misses (loads),
+// LLC_misses (loads), branch_misses and dTLB_misses (loads).
+//
+// Each event is its own perf_event_open fd counting the calling thread in
+// user space, with inherit set, so threads created after the PerfCounters
+// (std::threads spawned inside the loop, a worker pool built during setup)
+// are counted too. With ->Threads(n) every benchmark thread has its own
+// PerfCounters; Google Benchmark sums the counts and divides by the total
+// iterations, and averages IPC over the threads. When the PMU has fewer
+// counters than events the kernel multiplexes them and the counts are
+// scaled by enabled / running time.
+//
+// Events that cannot be opened - no PMU in a VM or container, seccomp,
+// perf_event_paranoid - are left out of the report; the reason is printed
+// to stderr once per event. Timing is unaffected either way.
+namespace perf_detail {
+
+struct Event {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_read_miss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Order matches the PerfCounters indices
+inline constexpr Event kEventTable[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1D_misses", PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {"LLC_misses", PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"dTLB_misses", PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_DTLB)},
+};
+
+} // namespace perf_detail
+
+class PerfCounters {
+public:
+    PerfCounters() {
+        for (int e = 0; e < kEvents; ++e)
+            fds_[e] = open_event(kEventTable[e]);
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+        for (int fd : fds_)
+            if (fd >= 0)
+                close(fd);
+    }
+
+    bool available() const {
+        for (int fd : fds_)
+            if (fd >= 0)
+                return true;
+        return false;
+    }
+
+    void start() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    void stop(benchmark::State& state) {
+        for (int fd : fds_)
+            if (fd >= 0)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+        double values[kEvents];
+        bool valid[kEvents];
+        for (int e = 0; e < kEvents; ++e) {
+            valid[e] = read_scaled(fds_[e], values[e]);
+            if (valid[e])
+                state.counters[kEventTable[e].name] = benchmark::Counter(values[e], benchmark::Counter::kAvgIterations);
+        }
+        if (valid[kCycles] && valid[kInstructions] && values[kCycles] > 0)
+            state.counters["IPC"] =
+                benchmark::Counter(values[kInstructions] / values[kCycles], benchmark::Counter::kAvgThreads);
+    }
+
+private:
+    using Event = perf_detail::Event;
+    enum { kCycles, kInstructions, kL1dMisses, kLlcMisses, kBranchMisses, kDtlbMisses, kEvents };
+    static constexpr const Event* kEventTable = perf_detail::kEventTable;
+
+    static int open_event(const Event& event) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0)
+            warn_once(event, errno);
+        return fd;
+    }
+
+    // One line per event per process, not one per benchmark
+    static void warn_once(const Event& event, int error) {
+        static std::atomic<bool> warned[kEvents];
+        if (!warned[&event - kEventTable].exchange(true))
+            std::fprintf(stderr, "perf_event_open(%s): %s; not reported\n", event.name, std::strerror(error));
+    }
+
+    static bool read_scaled(int fd, double& value) {
+        if (fd < 0)
+            return false;
+        uint64_t data[3]; // value, time enabled, time running
+        if (read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+            return false;
+        value = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        return true;
+    }
+
+    int fds_[kEvents];
+
+    static_assert(sizeof(perf_detail::kEventTable) / sizeof(Event) == kEvents);
+};
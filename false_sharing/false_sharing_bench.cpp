@@ -1,4 +1,5 @@
 #include <benchmark/benchmark.h>
+#include "perf_counters.h"
 #include <atomic>
 #include <thread>
 #include <vector>
@@ -32,6 +33,8 @@ void work(std::atomic<int>& var) {
 
 // Benchmark false sharing scenario
 static void BM_FalseSharing(benchmark::State& state) {
+    PerfCounters perf;
+    perf.start();
     for (auto _ : state) {
         sharedFalse.a = 0;
         sharedFalse.b = 0;
@@ -48,11 +51,14 @@ static void BM_FalseSharing(benchmark::State& state) {
         t3.join();
         t4.join();
     }
+    perf.stop(state);
 }
 BENCHMARK(BM_FalseSharing);
 
 // Benchmark true sharing scenario (avoiding false sharing)
 static void BM_TrueSharing(benchmark::State& state) {
+    PerfCounters perf;
+    perf.start();
     for (auto _ : state) {
         sharedTrue.a.value = 0;
         sharedTrue.b.value = 0;
@@ -69,6 +75,7 @@ static void BM_TrueSharing(benchmark::State& state) {
         t3.join();
         t4.join();
     }
+    perf.stop(state);
 }
 BENCHMARK(BM_TrueSharing);
 
@@ -0,0 +1,437 @@
+#pragma once
+
+#include "gemm.h"
+#include "matrix.h"
+#include "qgemm.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+// ----------------------------------------------------
+// GEMM autotuner and tuning cache
+// ----------------------------------------------------
+//
+// The defaults of gemm and qgemm are sized for one machine; the best mc,
+// kc, nc and loop order move with the sizes and associativity of L1, L2
+// and L3. autotune<T>(m, k, n) times candidate Tilings on m x k and k x n
+// matrices and returns the fastest:
+//
+//   1. seeds per LoopOrder from the cache geometry sysconf reports:
+//        kc  MR and NR slivers of depth kc fill L1 less one way
+//        mc  the mc x kc block of a fills half of L2 less one way
+//        nc  ColumnsOuter: half of L3 (at most 8192)
+//            RowsOuter:    the kc x nc panel of b fills half of L2
+//   2. from each seed, a coordinate search: kc over 1/4 .. 2x the seed,
+//      then mc, then nc, each step keeping the best so far
+//   3. the default tiling is measured too, so the winner is never worse
+//      than the default by more than the timing noise
+//
+// Each candidate is timed as the fastest of at least two runs; with about
+// twenty candidates per order, tuning n = 2048 takes tens of seconds.
+//
+// TuningCache keeps the winners keyed by (host, type, size class) and
+// reads and writes them as a text file, one entry per line:
+//
+//   # host type size mc kc nc order gops
+//   Intel(R)_Xeon(R)_Processor/6.143/48K.12-2048K.16-107520K.15 float 2048 112 384 4096 columns 96.4
+//
+// host names the CPU model and its cache geometry, so one file can be
+// shared by machines of several generations: each only uses its own lines
+// and keeps the others when it saves. The size class is the largest
+// dimension rounded down to a power of two, so 2048 and 2049 share an
+// entry.
+
+namespace tuning_detail {
+
+// gemm for float and int32_t, qgemm for int8_t and int16_t
+template <typename T, typename = void>
+struct Kernel;
+
+template <typename T>
+struct Kernel<T, std::enable_if_t<std::is_same_v<T, float> || std::is_same_v<T, int32_t>>> {
+    using Out = T;
+    static constexpr const char* name = std::is_same_v<T, float> ? "float" : "int32";
+    static constexpr size_t kMr = gemm_detail::kMr;
+    static constexpr size_t kNr = gemm_detail::kNr;
+    static constexpr size_t kPackedBytes = sizeof(T);
+
+    static Tiling default_tiling() { return gemm_default_tiling(); }
+    static Tiling normalize(const Tiling& t) { return gemm_detail::normalize(t); }
+    static void run(const Matrix<T>& a, const Matrix<T>& b, Matrix<Out>& c, const Tiling& t) { gemm(a, b, c, t); }
+};
+
+template <typename T>
+struct Kernel<T, std::enable_if_t<std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>>> {
+    using Out = int32_t;
+    static constexpr const char* name = std::is_same_v<T, int8_t> ? "int8" : "int16";
+    static constexpr size_t kMr = qgemm_detail::kMr;
+    static constexpr size_t kNr = qgemm_detail::kNr;
+    static constexpr size_t kPackedBytes = sizeof(typename qgemm_detail::Format<T>::B);
+
+    static Tiling default_tiling() { return qgemm_default_tiling(); }
+    static Tiling normalize(const Tiling& t) { return qgemm_detail::normalize(t); }
+    static void run(const Matrix<T>& a, const Matrix<T>& b, Matrix<Out>& c, const Tiling& t) { qgemm(a, b, c, t); }
+};
+
+struct CacheLevel {
+    size_t size;
+    size_t ways; // 0 when unknown
+
+    // Bytes a working set can take without evicting the lines streamed
+    // past it: one way is left to the streams
+    size_t usable() const { return ways > 1 ? size / ways * (ways - 1) : size / 4 * 3; }
+};
+
+struct CacheInfo {
+    CacheLevel l1d;
+    CacheLevel l2;
+    CacheLevel l3;
+};
+
+inline CacheLevel cache_level(int size_name, int ways_name, size_t fallback) {
+    const long size = sysconf(size_name);
+    const long ways = sysconf(ways_name);
+    return CacheLevel{size > 0 ? static_cast<size_t>(size) : fallback, ways > 0 ? static_cast<size_t>(ways) : 0};
+}
+
+// glibc reads these from CPUID; a level it cannot see gets a typical size
+inline CacheInfo cache_info() {
+    return CacheInfo{cache_level(_SC_LEVEL1_DCACHE_SIZE, _SC_LEVEL1_DCACHE_ASSOC, size_t{32} << 10),
+                     cache_level(_SC_LEVEL2_CACHE_SIZE, _SC_LEVEL2_CACHE_ASSOC, size_t{1} << 20),
+                     cache_level(_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL3_CACHE_ASSOC, size_t{8} << 20)};
+}
+
+inline std::string trim(const std::string& s) {
+    const size_t begin = s.find_first_not_of(" \t");
+    const size_t end = s.find_last_not_of(" \t");
+    return begin == std::string::npos ? std::string() : s.substr(begin, end - begin + 1);
+}
+
+inline const char* order_name(LoopOrder order) {
+    return order == LoopOrder::ColumnsOuter ? "columns" : "rows";
+}
+
+inline bool parse_order(const std::string& name, LoopOrder& order) {
+    if (name != "columns" && name != "rows")
+        return false;
+    order = name == "columns" ? LoopOrder::ColumnsOuter : LoopOrder::RowsOuter;
+    return true;
+}
+
+// A decimal count in [1, max]. No sign: istream would read "-1" into a
+// size_t as SIZE_MAX.
+inline bool parse_size(const std::string& token, size_t max, size_t& value) {
+    if (token.empty() || token.size() > 20 || token.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    const unsigned long long parsed = std::strtoull(token.c_str(), nullptr, 10);
+    if (parsed == 0 || parsed > max)
+        return false;
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+inline size_t round_down(size_t x, size_t to) {
+    return std::max(x / to * to, to);
+}
+
+struct TilingLess {
+    bool operator()(const Tiling& x, const Tiling& y) const {
+        return std::tie(x.mc, x.kc, x.nc, x.order) < std::tie(y.mc, y.kc, y.nc, y.order);
+    }
+};
+
+// Inputs only have to be finite and not denormal; the values do not
+// change the time
+template <typename T>
+Matrix<T> tuning_input(size_t rows, size_t cols) {
+    Matrix<T> m(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            m(i, j) = static_cast<T>((i * 31 + j * 17) % 64);
+    return m;
+}
+
+template <typename T>
+class Search {
+public:
+    using K = Kernel<T>;
+
+    Search(size_t m, size_t k, size_t n)
+        : m_(m), k_(k), n_(n), a_(tuning_input<T>(m, k)), b_(tuning_input<T>(k, n)), c_(m, n) {}
+
+    // Seconds for one multiply with t, the fastest of at least two runs
+    // and 50 ms. Tilings that only differ in blocks larger than the
+    // matrices multiply the same way and are timed once.
+    double time(const Tiling& tiling) {
+        const Tiling t = K::normalize(tiling);
+        const Tiling same = K::normalize(Tiling{std::min(t.mc, m_), std::min(t.kc, k_), std::min(t.nc, n_), t.order});
+        auto it = seconds_.find(same);
+        if (it != seconds_.end())
+            return it->second;
+
+        using Clock = std::chrono::steady_clock;
+        double best = 0;
+        double total = 0;
+        for (int run = 0; run < 2 || total < 0.05; ++run) {
+            const auto start = Clock::now();
+            K::run(a_, b_, c_, t);
+            const double s = std::chrono::duration<double>(Clock::now() - start).count();
+            best = run == 0 ? s : std::min(best, s);
+            total += s;
+        }
+        seconds_.emplace(same, best);
+        if (best < best_seconds_ || seconds_.size() == 1) {
+            best_seconds_ = best;
+            best_ = t;
+        }
+        return best;
+    }
+
+    // Tries every value of *field in values, keeping the best in place
+    void sweep(Tiling& t, size_t Tiling::*field, const std::vector<size_t>& values) {
+        double best = time(t);
+        for (size_t v : values) {
+            Tiling candidate = t;
+            candidate.*field = v;
+            const double s = time(candidate);
+            if (s < best) {
+                best = s;
+                t = K::normalize(candidate);
+            }
+        }
+    }
+
+    const Tiling& best() const { return best_; }
+    double best_seconds() const { return best_seconds_; }
+    size_t candidates() const { return seconds_.size(); }
+
+private:
+    size_t m_;
+    size_t k_;
+    size_t n_;
+    Matrix<T> a_;
+    Matrix<T> b_;
+    Matrix<typename K::Out> c_;
+    std::map<Tiling, double, TilingLess> seconds_;
+    Tiling best_;
+    double best_seconds_ = 0;
+};
+
+// Starting point for one loop order, from the cache geometry
+template <typename T>
+Tiling seed_tiling(const CacheInfo& caches, LoopOrder order) {
+    using K = Kernel<T>;
+    const size_t bytes = K::kPackedBytes;
+    const size_t kc = round_down(caches.l1d.usable() / ((K::kMr + K::kNr) * bytes), 16);
+    const size_t mc = round_down(caches.l2.usable() / 2 / (kc * bytes), K::kMr);
+    const size_t nc = order == LoopOrder::ColumnsOuter
+                          ? std::min<size_t>(8192, round_down(caches.l3.usable() / 2 / (kc * bytes), K::kNr))
+                          : round_down(caches.l2.usable() / 2 / (kc * bytes), K::kNr);
+    return Tiling{mc, kc, nc, order};
+}
+
+// x / 4 .. 2x; the sweep rounds them to the micro-tile
+inline std::vector<size_t> around(size_t x, size_t step) {
+    std::vector<size_t> values;
+    for (size_t num : {1, 2, 3, 4, 6, 8})
+        values.push_back(round_down(x * num / 4, step));
+    return values;
+}
+
+} // namespace tuning_detail
+
+struct TuneResult {
+    Tiling tiling;
+    double gops;         // multiply-adds count as two
+    double default_gops; // gemm_default_tiling / qgemm_default_tiling
+    size_t candidates;   // distinct tilings timed
+};
+
+// Fastest tiling found for an m x k by k x n multiply of T on this host
+template <typename T>
+TuneResult autotune(size_t m, size_t k, size_t n) {
+    using namespace tuning_detail;
+    using K = Kernel<T>;
+
+    Search<T> search(m, k, n);
+    const double default_seconds = search.time(K::default_tiling());
+    const CacheInfo caches = cache_info();
+    for (LoopOrder order : {LoopOrder::ColumnsOuter, LoopOrder::RowsOuter}) {
+        Tiling t = K::normalize(seed_tiling<T>(caches, order));
+        search.sweep(t, &Tiling::kc, around(t.kc, 16));
+        search.sweep(t, &Tiling::mc, around(t.mc, K::kMr));
+        search.sweep(t, &Tiling::nc, around(t.nc, K::kNr));
+    }
+
+    const double ops = 2.0 * m * k * n;
+    return TuneResult{search.best(), ops / search.best_seconds() * 1e-9, ops / default_seconds * 1e-9,
+                      search.candidates()};
+}
+
+// CPU model, family.model and cache geometry, without spaces
+inline std::string host_id() {
+    using namespace tuning_detail;
+
+    std::string model = "unknown";
+    std::string family = "0";
+    std::string number = "0";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    for (std::string line; std::getline(cpuinfo, line) && !line.empty();) { // first processor only
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos)
+            continue;
+        const std::string key = trim(line.substr(0, colon));
+        const std::string value = trim(line.substr(colon + 1));
+        if (key == "model name")
+            model = value;
+        else if (key == "cpu family")
+            family = value;
+        else if (key == "model")
+            number = value;
+    }
+    for (char& ch : model)
+        if (std::isspace(static_cast<unsigned char>(ch)))
+            ch = '_';
+
+    const CacheInfo caches = cache_info();
+    std::ostringstream id;
+    id << model << '/' << family << '.' << number << '/';
+    id << (caches.l1d.size >> 10) << "K." << caches.l1d.ways << '-';
+    id << (caches.l2.size >> 10) << "K." << caches.l2.ways << '-';
+    id << (caches.l3.size >> 10) << "K." << caches.l3.ways;
+    return id.str();
+}
+
+class TuningCache {
+public:
+    struct Entry {
+        Tiling tiling;
+        double gops;
+    };
+
+    // Largest mc, kc or nc load() accepts; far beyond any cache, and small
+    // enough that a bad file cannot ask for a huge pack buffer
+    static constexpr size_t kMaxBlock = size_t{1} << 16;
+
+    explicit TuningCache(std::string host = host_id()) : host_(std::move(host)) {}
+
+    const std::string& host() const { return host_; }
+    size_t size() const { return entries_.size(); }
+
+    // Largest dimension rounded down to a power of two, at least 64
+    static size_t size_class(size_t m, size_t k, size_t n) {
+        const size_t largest = std::max({m, k, n, size_t{64}});
+        size_t cls = 64;
+        while (cls <= largest / 2)
+            cls *= 2;
+        return cls;
+    }
+
+    // Merges the entries of path over the current ones. False when the
+    // file cannot be read; malformed lines, including signed or zero
+    // sizes and blocks above kMaxBlock, are skipped with a warning.
+    bool load(const std::string& path) {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+        size_t line_number = 0;
+        for (std::string line; std::getline(in, line);) {
+            ++line_number;
+            const std::string content = tuning_detail::trim(line);
+            if (content.empty() || content[0] == '#')
+                continue;
+            std::istringstream fields(line);
+            std::string host, type, cls_field, mc, kc, nc, order;
+            size_t cls = 0;
+            Entry entry{};
+            fields >> host >> type >> cls_field >> mc >> kc >> nc >> order >> entry.gops;
+            using tuning_detail::parse_size;
+            if (!fields || !parse_size(cls_field, SIZE_MAX, cls) || !parse_size(mc, kMaxBlock, entry.tiling.mc) ||
+                !parse_size(kc, kMaxBlock, entry.tiling.kc) || !parse_size(nc, kMaxBlock, entry.tiling.nc) ||
+                !tuning_detail::parse_order(order, entry.tiling.order)) {
+                std::fprintf(stderr, "%s:%zu: malformed tuning entry, skipped\n", path.c_str(), line_number);
+                continue;
+            }
+            entries_[Key{host, type, cls}] = entry;
+        }
+        return true;
+    }
+
+    // Writes every entry, this host's and the others', through a temporary
+    // file so that a failed write leaves the old file intact
+    bool save(const std::string& path) const {
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp);
+            out << "# host type size mc kc nc order gops\n";
+            for (const auto& [key, entry] : entries_) {
+                const auto& [host, type, cls] = key;
+                out << host << ' ' << type << ' ' << cls << ' ' << entry.tiling.mc << ' ' << entry.tiling.kc << ' '
+                    << entry.tiling.nc << ' ' << tuning_detail::order_name(entry.tiling.order) << ' ' << entry.gops
+                    << '\n';
+            }
+            if (!out.flush())
+                return false;
+        }
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    // This host's entry for T at the size class of m, k, n, or nullptr
+    template <typename T>
+    const Entry* find(size_t m, size_t k, size_t n) const {
+        const auto it = entries_.find(key<T>(m, k, n));
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    // The tuned tiling, or the default one when there is no entry
+    template <typename T>
+    Tiling tiling(size_t m, size_t k, size_t n) const {
+        const Entry* entry = find<T>(m, k, n);
+        return entry ? entry->tiling : tuning_detail::Kernel<T>::default_tiling();
+    }
+
+    // Runs autotune and records the winner for the size class of m, k, n
+    template <typename T>
+    TuneResult tune(size_t m, size_t k, size_t n) {
+        const TuneResult result = autotune<T>(m, k, n);
+        entries_[key<T>(m, k, n)] = Entry{result.tiling, result.gops};
+        return result;
+    }
+
+private:
+    using Key = std::tuple<std::string, std::string, size_t>; // host, type, size class
+
+    template <typename T>
+    Key key(size_t m, size_t k, size_t n) const {
+        return Key{host_, tuning_detail::Kernel<T>::name, size_class(m, k, n)};
+    }
+
+    std::string host_;
+    std::map<Key, Entry> entries_;
+};
+
+// int32_t for the int8_t / int16_t inputs of qgemm, T for gemm
+template <typename T>
+using GemmOutput = typename tuning_detail::Kernel<T>::Out;
+
+// gemm or qgemm, whichever handles T, with the tiling cache holds for this
+// host and the shape of a and b
+template <typename T>
+void tuned_gemm(const TuningCache& cache, const Matrix<T>& a, const Matrix<T>& b, Matrix<GemmOutput<T>>& c) {
+    tuning_detail::Kernel<T>::run(a, b, c, cache.tiling<T>(a.rows(), a.cols(), b.cols()));
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "matrix.h"
+#include "tiling.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------
+// Packed GEMM (BLIS / GotoBLAS structure)
+// ----------------------------------------------------
+//
+// c = a * b for float and int32_t:
+//
+//   for jc in steps of nc:            kc x nc panel of b  -> packed, L3
+//     for pc in steps of kc:
+//       pack b[pc.., jc..] into NR-wide slivers
+//       for ic in steps of mc:        mc x kc block of a  -> packed, L2
+//         pack a[ic.., pc..] into MR-tall slivers
+//         for each NR sliver of b     (kc x NR, stays in L1)
+//           for each MR sliver of a   (swapped by LoopOrder::RowsOuter)
+//             micro-kernel: MR x NR block of c in registers,
+//                           kc rank-1 updates
+//
+// Packing makes every load of the micro-kernel contiguous and aligned, and
+// pads partial slivers with zeros so the kernel never needs an edge case;
+// only the final store of a partial tile goes through a small buffer.
+//
+// The micro-kernel is written once over a SIMD register type and sized for
+// the instruction set the translation unit is compiled for:
+//
+//   AVX-512  14 x 32  (28 accumulators of 32 zmm registers)
+//   AVX2      6 x 16  (12 accumulators of 16 ymm registers)
+//   scalar    4 x 4
+//
+// int32_t uses mullo + add where float uses FMA, and unsigned arithmetic
+// in the scalar fallback, so every path wraps on overflow instead of being
+// undefined like the scalar int loops.
+
+namespace gemm_detail {
+
+// Unsigned for integers, where overflow wraps instead of being undefined
+template <typename T>
+using Wrapping = typename std::conditional_t<std::is_integral_v<T>, std::make_unsigned<T>, std::common_type<T>>::type;
+
+template <typename T>
+T wrapping_add(T a, T b) {
+    return static_cast<T>(static_cast<Wrapping<T>>(a) + static_cast<Wrapping<T>>(b));
+}
+
+template <typename T, typename = void>
+struct Simd;
+
+#if defined(__AVX512F__)
+
+template <>
+struct Simd<float> {
+    using reg = __m512;
+    static constexpr size_t width = 16;
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg set1(float x) { return _mm512_set1_ps(x); }
+    static reg load(const float* p) { return _mm512_load_ps(p); }
+    static reg loadu(const float* p) { return _mm512_loadu_ps(p); }
+    static void storeu(float* p, reg v) { _mm512_storeu_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_ps(a, b); }
+    static reg madd(reg a, reg b, reg c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+template <>
+struct Simd<int32_t> {
+    using reg = __m512i;
+    static constexpr size_t width = 16;
+    static reg zero() { return _mm512_setzero_si512(); }
+    static reg set1(int32_t x) { return _mm512_set1_epi32(x); }
+    static reg load(const int32_t* p) { return _mm512_load_si512(p); }
+    static reg loadu(const int32_t* p) { return _mm512_loadu_si512(p); }
+    static void storeu(int32_t* p, reg v) { _mm512_storeu_si512(p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    static reg madd(reg a, reg b, reg c) { return _mm512_add_epi32(_mm512_mullo_epi32(a, b), c); }
+};
+
+inline constexpr size_t kMr = 14;
+inline constexpr size_t kNr = 32;
+
+#elif defined(__AVX2__)
+
+template <>
+struct Simd<float> {
+    using reg = __m256;
+    static constexpr size_t width = 8;
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg set1(float x) { return _mm256_set1_ps(x); }
+    static reg load(const float* p) { return _mm256_load_ps(p); }
+    static reg loadu(const float* p) { return _mm256_loadu_ps(p); }
+    static void storeu(float* p, reg v) { _mm256_storeu_ps(p, v); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+#if defined(__FMA__)
+    static reg madd(reg a, reg b, reg c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    static reg madd(reg a, reg b, reg c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+};
+
+template <>
+struct Simd<int32_t> {
+    using reg = __m256i;
+    static constexpr size_t width = 8;
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg set1(int32_t x) { return _mm256_set1_epi32(x); }
+    static reg load(const int32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static reg loadu(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storeu(int32_t* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg madd(reg a, reg b, reg c) { return _mm256_add_epi32(_mm256_mullo_epi32(a, b), c); }
+};
+
+inline constexpr size_t kMr = 6;
+inline constexpr size_t kNr = 16;
+
+#else
+
+// One "register" is one element. Integers are added and multiplied as
+// unsigned, so they wrap like the SIMD lanes do.
+template <typename T>
+struct Simd<T, std::enable_if_t<std::is_arithmetic_v<T>>> {
+    using reg = T;
+    using Wrap = Wrapping<T>;
+    static constexpr size_t width = 1;
+    static reg zero() { return T{}; }
+    static reg set1(T x) { return x; }
+    static reg load(const T* p) { return *p; }
+    static reg loadu(const T* p) { return *p; }
+    static void storeu(T* p, reg v) { *p = v; }
+    static reg add(reg a, reg b) { return wrapping_add(a, b); }
+    static reg madd(reg a, reg b, reg c) {
+        return static_cast<T>(static_cast<Wrap>(a) * static_cast<Wrap>(b) + static_cast<Wrap>(c));
+    }
+};
+
+inline constexpr size_t kMr = 4;
+inline constexpr size_t kNr = 4;
+
+#endif
+
+// a: kc x MR (packed), b: kc x NR (packed). Writes c = acc (overwrite) or
+// c += acc for the top-left rows x cols corner of the MR x NR tile.
+template <typename T>
+inline void micro_kernel(size_t kc, const T* __restrict a, const T* __restrict b, T* c, size_t ldc, size_t rows,
+                         size_t cols, bool overwrite) {
+    using V = Simd<T>;
+    constexpr size_t nv = kNr / V::width;
+
+    typename V::reg acc[kMr][nv];
+#pragma GCC unroll 16
+    for (size_t i = 0; i < kMr; ++i)
+#pragma GCC unroll 4
+        for (size_t v = 0; v < nv; ++v)
+            acc[i][v] = V::zero();
+
+    for (size_t p = 0; p < kc; ++p) {
+        typename V::reg bv[nv];
+#pragma GCC unroll 4
+        for (size_t v = 0; v < nv; ++v)
+            bv[v] = V::load(b + v * V::width);
+#pragma GCC unroll 16
+        for (size_t i = 0; i < kMr; ++i) {
+            const typename V::reg ai = V::set1(a[i]);
+#pragma GCC unroll 4
+            for (size_t v = 0; v < nv; ++v)
+                acc[i][v] = V::madd(ai, bv[v], acc[i][v]);
+        }
+        a += kMr;
+        b += kNr;
+    }
+
+    if (rows == kMr && cols == kNr) {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < kMr; ++i)
+#pragma GCC unroll 4
+            for (size_t v = 0; v < nv; ++v) {
+                T* dst = c + i * ldc + v * V::width;
+                V::storeu(dst, overwrite ? acc[i][v] : V::add(V::loadu(dst), acc[i][v]));
+            }
+        return;
+    }
+
+    alignas(64) T tile[kMr * kNr];
+    for (size_t i = 0; i < kMr; ++i)
+        for (size_t v = 0; v < nv; ++v)
+            V::storeu(tile + i * kNr + v * V::width, acc[i][v]);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            c[i * ldc + j] = overwrite ? tile[i * kNr + j] : wrapping_add(c[i * ldc + j], tile[i * kNr + j]);
+}
+
+// kc x nc block of b -> NR-wide slivers, each kc x NR row-major, zero padded
+template <typename T>
+void pack_b(const Matrix<T>& b, size_t pc, size_t kc, size_t jc, size_t nc, T* out) {
+    for (size_t j = 0; j < nc; j += kNr) {
+        const size_t cols = std::min(kNr, nc - j);
+        for (size_t p = 0; p < kc; ++p) {
+            const T* src = b[pc + p] + jc + j;
+            size_t q = 0;
+            for (; q < cols; ++q)
+                out[q] = src[q];
+            for (; q < kNr; ++q)
+                out[q] = T{};
+            out += kNr;
+        }
+    }
+}
+
+// mc x kc block of a -> MR-tall slivers, each kc x MR (column of the sliver
+// contiguous), zero padded
+template <typename T>
+void pack_a(const Matrix<T>& a, size_t ic, size_t mc, size_t pc, size_t kc, T* out) {
+    for (size_t i = 0; i < mc; i += kMr) {
+        const size_t rows = std::min(kMr, mc - i);
+        for (size_t p = 0; p < kc; ++p) {
+            size_t r = 0;
+            for (; r < rows; ++r)
+                out[r] = a[ic + i + r][pc + p];
+            for (; r < kMr; ++r)
+                out[r] = T{};
+            out += kMr;
+        }
+    }
+}
+
+// Saturates at the largest multiple of to instead of wrapping to 0
+inline size_t round_up(size_t x, size_t to) {
+    const size_t largest = SIZE_MAX / to * to;
+    return x > largest ? largest : (x + to - 1) / to * to;
+}
+
+// mc and nc rounded up to the micro-tile, nothing zero
+inline Tiling normalize(const Tiling& tiling) {
+    return Tiling{round_up(std::max<size_t>(tiling.mc, 1), kMr), std::max<size_t>(tiling.kc, 1),
+                  round_up(std::max<size_t>(tiling.nc, 1), kNr), tiling.order};
+}
+
+// Blocks no larger than an m x k by k x n product needs, so that the pack
+// buffers are sized by the matrices and not by an oversized tiling
+inline Tiling fit(const Tiling& tiling, size_t m, size_t k, size_t n) {
+    return Tiling{std::min(tiling.mc, m), std::min(tiling.kc, k), std::min(tiling.nc, n), tiling.order};
+}
+
+// Scratch for one gemm_tile caller at a time
+template <typename T>
+struct PackBuffers {
+    AlignedArray<T> a;
+    AlignedArray<T> b;
+
+    // t normalized; cols is the widest tile this buffer will see
+    PackBuffers(const Tiling& t, size_t cols)
+        : a(make_aligned_array<T>(t.mc * t.kc)), b(make_aligned_array<T>(t.kc * std::min(t.nc, round_up(cols, kNr)))) {}
+};
+
+// c[row0.., col0..] = a[row0.., :] * b[:, col0..] for a rows x cols tile;
+// t normalized, a.cols() > 0
+template <typename T>
+void gemm_tile(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, size_t row0, size_t rows, size_t col0,
+               size_t cols, const Tiling& t, PackBuffers<T>& buffers) {
+    const size_t depth = a.cols();
+    for (size_t jc = col0; jc < col0 + cols; jc += t.nc) {
+        const size_t nb = std::min(t.nc, col0 + cols - jc);
+        for (size_t pc = 0; pc < depth; pc += t.kc) {
+            const size_t kb = std::min(t.kc, depth - pc);
+            pack_b(b, pc, kb, jc, nb, buffers.b.get());
+            for (size_t ic = row0; ic < row0 + rows; ic += t.mc) {
+                const size_t mb = std::min(t.mc, row0 + rows - ic);
+                pack_a(a, ic, mb, pc, kb, buffers.a.get());
+                auto tile = [&](size_t ir, size_t jr) {
+                    micro_kernel(kb, buffers.a.get() + ir * kb, buffers.b.get() + jr * kb, c[ic + ir] + jc + jr,
+                                 c.stride(), std::min(kMr, mb - ir), std::min(kNr, nb - jr), pc == 0);
+                };
+                if (t.order == LoopOrder::ColumnsOuter) {
+                    for (size_t jr = 0; jr < nb; jr += kNr)
+                        for (size_t ir = 0; ir < mb; ir += kMr)
+                            tile(ir, jr);
+                } else {
+                    for (size_t ir = 0; ir < mb; ir += kMr)
+                        for (size_t jr = 0; jr < nb; jr += kNr)
+                            tile(ir, jr);
+                }
+            }
+        }
+    }
+}
+
+} // namespace gemm_detail
+
+// Block sizes for gemm: mc x kc of a should sit in L2, kc x nc of b in L3.
+// mc and nc are rounded up to the micro-tile.
+inline Tiling gemm_default_tiling() {
+    return Tiling{gemm_detail::kMr * 8, 384, 4096};
+}
+
+template <typename T>
+void gemm(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, const Tiling& tiling = gemm_default_tiling()) {
+    using namespace gemm_detail;
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, int32_t>, "gemm supports float and int32_t");
+
+    const size_t m = a.rows();
+    const size_t n = b.cols();
+    if (a.cols() == 0) {
+        for (size_t i = 0; i < m; ++i)
+            std::fill(c[i], c[i] + n, T{});
+        return;
+    }
+
+    const Tiling t = normalize(fit(tiling, m, a.cols(), n));
+    PackBuffers<T> buffers(t, n);
+    gemm_tile(a, b, c, 0, m, 0, n, t, buffers);
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// ----------------------------------------------------
+// Uninitialized 64-byte aligned array
+// ----------------------------------------------------
+template <typename T>
+struct AlignedFree {
+    void operator()(T* p) const { ::operator delete[](p, std::align_val_t{64}); }
+};
+
+template <typename T>
+using AlignedArray = std::unique_ptr<T[], AlignedFree<T>>;
+
+template <typename T>
+AlignedArray<T> make_aligned_array(size_t count) {
+    if (count == 0) {
+        return nullptr;
+    }
+    return AlignedArray<T>(static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t{64})));
+}
+
+// ----------------------------------------------------
+// Contiguous row-major matrix
+// ----------------------------------------------------
+//
+// One 64-byte aligned allocation; row i starts at data() + i * stride().
+// The stride is at least cols() and every row starts on a cache line.
+//
+// Padding::AvoidAliasing (the default) also keeps the stride off multiples
+// of 4 KB. With a 4 KB stride, the elements of one column all map to the
+// same L1 set (and a handful of L2 sets), so walking down a column thrashes
+// a few ways while the rest of the cache sits idle. That is the 2048 vs
+// 2049 cliff of the vector<vector<int>> benchmarks. One extra cache line
+// per row spreads the column over all sets. Padding::None gives the tight
+// stride when the cliff is what you want to measure; an explicit stride
+// overrides both, rounded up to a cache line like the others.
+enum class Padding {
+    None,          // stride = cols rounded up to a cache line
+    AvoidAliasing, // ... plus one cache line if that is a multiple of 4 KB
+};
+
+// Explicit row stride in elements, for Matrix(rows, cols, Stride{...});
+// rounded up to cols and then to a cache line
+struct Stride {
+    size_t elems;
+};
+
+// Non-owning rows x cols window into row-major storage; T may be const
+template <typename T>
+struct MatrixView {
+    T* data;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+
+    T* operator[](size_t i) const { return data + i * stride; }
+
+    MatrixView block(size_t row0, size_t col0, size_t block_rows, size_t block_cols) const {
+        return MatrixView{data + row0 * stride + col0, block_rows, block_cols, stride};
+    }
+
+    operator MatrixView<const T>() const { return MatrixView<const T>{data, rows, cols, stride}; }
+};
+
+template <typename T>
+class Matrix {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kLineElems = kAlignment / sizeof(T);
+
+    Matrix() = default;
+
+    Matrix(size_t rows, size_t cols, Padding padding = Padding::AvoidAliasing)
+        : Matrix(rows, cols, Stride{default_stride(cols, padding)}) {}
+
+    Matrix(size_t rows, size_t cols, Stride stride)
+        : rows_(rows), cols_(cols), stride_(line_stride(stride.elems, cols)),
+          data_(make_aligned_array<T>(rows * stride_)) {
+        if (data_)
+            std::memset(data_.get(), 0, rows_ * stride_ * sizeof(T));
+    }
+
+    // Contents left uninitialized, so that whoever writes first decides
+    // where the pages live (first-touch NUMA placement)
+    static Matrix uninitialized(size_t rows, size_t cols, Padding padding = Padding::AvoidAliasing) {
+        return Matrix(rows, cols, default_stride(cols, padding), NoInit{});
+    }
+
+    Matrix(const Matrix& other)
+        : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_),
+          data_(make_aligned_array<T>(rows_ * stride_)) {
+        if (data_)
+            std::memcpy(data_.get(), other.data_.get(), rows_ * stride_ * sizeof(T));
+    }
+
+    Matrix& operator=(const Matrix& other) {
+        if (this != &other) {
+            *this = Matrix(other);
+        }
+        return *this;
+    }
+
+    Matrix(Matrix&&) noexcept = default;
+    Matrix& operator=(Matrix&&) noexcept = default;
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t stride() const { return stride_; }
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+
+    T* operator[](size_t i) { return data_.get() + i * stride_; }
+    const T* operator[](size_t i) const { return data_.get() + i * stride_; }
+
+    MatrixView<T> view() { return MatrixView<T>{data_.get(), rows_, cols_, stride_}; }
+    MatrixView<const T> view() const { return MatrixView<const T>{data_.get(), rows_, cols_, stride_}; }
+
+    T& operator()(size_t i, size_t j) { return data_.get()[i * stride_ + j]; }
+    const T& operator()(size_t i, size_t j) const { return data_.get()[i * stride_ + j]; }
+
+    // Compares the logical elements only; padding is ignored
+    bool operator==(const Matrix& other) const {
+        if (rows_ != other.rows_ || cols_ != other.cols_) {
+            return false;
+        }
+        for (size_t i = 0; i < rows_; ++i) {
+            if (!std::equal((*this)[i], (*this)[i] + cols_, other[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool operator!=(const Matrix& other) const { return !(*this == other); }
+
+    static size_t default_stride(size_t cols, Padding padding) {
+        size_t stride = (cols + kLineElems - 1) / kLineElems * kLineElems;
+        if (padding == Padding::AvoidAliasing && stride > 0 && (stride * sizeof(T)) % 4096 == 0) {
+            stride += kLineElems;
+        }
+        return stride;
+    }
+
+private:
+    struct NoInit {};
+
+    Matrix(size_t rows, size_t cols, size_t stride, NoInit)
+        : rows_(rows), cols_(cols), stride_(line_stride(stride, cols)), data_(make_aligned_array<T>(rows * stride_)) {}
+
+    // At least cols and a whole number of cache lines, so every row starts
+    // on a line
+    static size_t line_stride(size_t stride, size_t cols) {
+        return (std::max(stride, cols) + kLineElems - 1) / kLineElems * kLineElems;
+    }
+
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    size_t stride_ = 0;
+    AlignedArray<T> data_;
+};
@@ -1,8 +1,22 @@
 #include <benchmark/benchmark.h>
+#include "perf_counters.h"
+#include "matrix.h"
+#include "tiled_mul.h"
+#include "gemm.h"
+#include "parallel_gemm.h"
+#include "recursive_mul.h"
+#include "strassen.h"
+#include "small_matrix.h"
+#include "transpose.h"
+#include "qgemm.h"
+#include "autotune.h"
 #include <vector>
 #include <cstdlib>
 #include <iostream>
 #include <ctime>
+#include <thread>
+#include <algorithm>
+#include <string>
 
 template <size_t n>
 void mul1(std::vector<std::vector<int>>& a, std::vector<std::vector<int>>& b, std::vector<std::vector<int>>& c) {
@@ -15,6 +29,8 @@ void mul1(std::vector<std::vector<int>>& a, std::vector<std::vector<int>>& b, st
         }
 }
 
+// Transposes b in place, so b alternates between b and b^T from one call
+// to the next and every other result is a * b^T; see mul2_matrix
 template <size_t n>
 void mul2(std::vector<std::vector<int>>& a, std::vector<std::vector<int>>& b, std::vector<std::vector<int>>& c) {
     for (size_t i = 0; i < n; ++i)
@@ -38,9 +54,57 @@ void fill_random(std::vector<std::vector<int>>& matrix) {
             matrix[i][j] = rand() % 100;  // Random values between 0 and 99
 }
 
+template <typename T>
+void fill_random(Matrix<T>& matrix) {
+    for (size_t i = 0; i < matrix.rows(); ++i)
+        for (size_t j = 0; j < matrix.cols(); ++j)
+            matrix(i, j) = rand() % 100;
+}
+
+// mul1 on the contiguous Matrix, to show the column walk with and without
+// the aliasing padding
+template <typename T>
+void mul1_matrix(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c) {
+    const size_t n = a.rows();
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) {
+            T sum = 0;
+            for (size_t k = 0; k < n; ++k)
+                sum += a(i, k) * b(k, j);
+            c(i, j) = sum;
+        }
+}
+
+// mul2 on the contiguous Matrix: b^T goes into a separate buffer with the
+// blocked transpose, so b is left alone and every call gives a * b
+template <typename T>
+void mul2_matrix(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, Matrix<T>& bt) {
+    transpose(b, bt);
+    const size_t n = a.rows();
+    const size_t depth = a.cols();
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < b.cols(); ++j) {
+            const T* ai = a[i];
+            const T* btj = bt[j];
+            T sum = 0;
+            for (size_t k = 0; k < depth; ++k)
+                sum += ai[k] * btj[k];
+            c(i, j) = sum;
+        }
+}
+
+// Element-by-element out-of-place transpose, the baseline for transpose()
+template <typename T>
+void transpose_naive(const Matrix<T>& src, Matrix<T>& dst) {
+    for (size_t i = 0; i < src.rows(); ++i)
+        for (size_t j = 0; j < src.cols(); ++j)
+            dst(j, i) = src(i, j);
+}
+
 // Benchmark for mul1
 template <size_t n>
 static void BM_Mul1(benchmark::State& state) {
+    PerfCounters perf;
     std::vector<std::vector<int>> a(n, std::vector<int>(n));
     std::vector<std::vector<int>> b(n, std::vector<int>(n));
     std::vector<std::vector<int>> c(n, std::vector<int>(n));
@@ -48,15 +112,18 @@ static void BM_Mul1(benchmark::State& state) {
     fill_random<n>(a);
     fill_random<n>(b);
 
+    perf.start();
     for (auto _ : state) {
         mul1<n>(a, b, c);
         benchmark::DoNotOptimize(c);
     }
+    perf.stop(state);
 }
 
 // Benchmark for mul2
 template <size_t n>
 static void BM_Mul2(benchmark::State& state) {
+    PerfCounters perf;
     std::vector<std::vector<int>> a(n, std::vector<int>(n));
     std::vector<std::vector<int>> b(n, std::vector<int>(n));
     std::vector<std::vector<int>> c(n, std::vector<int>(n));
@@ -64,10 +131,319 @@ static void BM_Mul2(benchmark::State& state) {
     fill_random<n>(a);
     fill_random<n>(b);
 
+    perf.start();
     for (auto _ : state) {
         mul2<n>(a, b, c);
         benchmark::DoNotOptimize(c);
     }
+    perf.stop(state);
+}
+
+// Benchmark for mul1 on Matrix<int> with the given padding
+template <size_t n, Padding padding>
+static void BM_Mul1Matrix(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<int> a(n, n, padding), b(n, n, padding), c(n, n, padding);
+    fill_random(a);
+    fill_random(b);
+
+    perf.start();
+    for (auto _ : state) {
+        mul1_matrix(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.counters["stride"] = static_cast<double>(b.stride());
+}
+
+// Benchmark for mul2 with the out-of-place transpose; the transpose is
+// part of every iteration, as in mul2. The result is first checked
+// against gemm.
+template <size_t n>
+static void BM_Mul2Matrix(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<int> a(n, n), b(n, n), c(n, n), bt(n, n);
+    fill_random(a);
+    fill_random(b);
+    {
+        Matrix<int> expected(n, n);
+        mul2_matrix(a, b, c, bt);
+        gemm(a, b, expected);
+        if (c != expected) {
+            state.SkipWithError("mul2_matrix differs from gemm");
+            return;
+        }
+    }
+
+    perf.start();
+    for (auto _ : state) {
+        mul2_matrix(a, b, c, bt);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+}
+
+// Transpose throughput; bytes are one read and one write of the matrix
+template <size_t n, bool blocked>
+static void BM_Transpose(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<float> src(n, n), dst(n, n);
+    fill_random(src);
+
+    perf.start();
+    for (auto _ : state) {
+        if (blocked)
+            transpose(src, dst);
+        else
+            transpose_naive(src, dst);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    perf.stop(state);
+    state.SetBytesProcessed(state.iterations() * 2 * n * n * sizeof(float));
+}
+
+// Benchmark for the cache-blocked multiply
+template <size_t n>
+static void BM_MulTiled(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<int> a(n, n), b(n, n), c(n, n);
+    fill_random(a);
+    fill_random(b);
+
+    perf.start();
+    for (auto _ : state) {
+        mul_tiled(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+
+// Benchmark for the packed GEMM; flops counts a multiply-add as two
+template <typename T, size_t n>
+static void BM_Gemm(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<T> a(n, n), b(n, n), c(n, n);
+    fill_random(a);
+    fill_random(b);
+
+    perf.start();
+    for (auto _ : state) {
+        gemm(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.counters["flops"] = benchmark::Counter(2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// Benchmark for the int8 / int16 GEMM with int32 output; ops counts a
+// multiply-add as two, as flops does for gemm. Up to 1024 the result is
+// first checked against qgemm_reference.
+template <typename T, size_t n>
+static void BM_QGemm(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<T> a(n, n), b(n, n);
+    Matrix<int32_t> c(n, n);
+    fill_random(a);
+    fill_random(b);
+    if (n <= 1024) {
+        Matrix<int32_t> expected(n, n);
+        qgemm(a, b, c);
+        qgemm_reference(a, b, expected);
+        if (c != expected) {
+            state.SkipWithError("qgemm differs from qgemm_reference");
+            return;
+        }
+    }
+
+    perf.start();
+    for (auto _ : state) {
+        qgemm(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.counters["ops"] = benchmark::Counter(2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// Tilings found by --autotune, loaded from --tuning_file in main
+static TuningCache tuning;
+
+// gemm / qgemm with the tiling the tuning cache holds for this host, type
+// and size class; the label shows it, or "default" without an entry
+template <typename T, size_t n>
+static void BM_GemmTuned(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<T> a(n, n), b(n, n);
+    Matrix<GemmOutput<T>> c(n, n);
+    fill_random(a);
+    fill_random(b);
+    if (const TuningCache::Entry* entry = tuning.find<T>(n, n, n)) {
+        const Tiling& t = entry->tiling;
+        state.SetLabel("mc=" + std::to_string(t.mc) + " kc=" + std::to_string(t.kc) + " nc=" + std::to_string(t.nc) +
+                       (t.order == LoopOrder::ColumnsOuter ? " columns" : " rows"));
+    } else {
+        state.SetLabel("default");
+    }
+
+    perf.start();
+    for (auto _ : state) {
+        tuned_gemm(tuning, a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.counters["ops"] = benchmark::Counter(2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// Benchmark for the cache-oblivious recursive multiply
+template <size_t n>
+static void BM_MulRecursive(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<int> a(n, n), b(n, n), c(n, n);
+    fill_random(a);
+    fill_random(b);
+
+    perf.start();
+    for (auto _ : state) {
+        mul_recursive(a, b, c);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.SetItemsProcessed(state.iterations() * n * n * n);
+}
+
+// Benchmark for Strassen with crossover state.range(0); the scratch is
+// allocated once outside the loop. Items are the n^3 of the classical
+// product, so the rate is comparable with the other variants.
+template <size_t n>
+static void BM_MulStrassen(benchmark::State& state) {
+    PerfCounters perf;
+    Matrix<int> a(n, n), b(n, n), c(n, n);
+    fill_random(a);
+    fill_random(b);
+    StrassenScratch<int> scratch(n, n, n, static_cast<size_t>(state.range(0)));
+
+    perf.start();
+    for (auto _ : state) {
+        mul_strassen(a, b, c, scratch);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.SetItemsProcessed(state.iterations() * n * n * n);
+    state.counters["levels"] = static_cast<double>(scratch.levels());
+}
+
+// Small-matrix batches of state.range(0) products per iteration; items are
+// matrices. 16 matrices keep all three arrays in L1 for N <= 8 (and in L2
+// for N = 16); 16384 stream them from L2 (N = 4) or memory (N = 16).
+static void SmallBatchSizes(benchmark::internal::Benchmark* b) {
+    b->ArgName("batch")->Arg(16)->Arg(1 << 14);
+}
+
+template <typename T, size_t N>
+std::vector<SmallMatrix<T, N>> random_small(size_t count) {
+    std::vector<SmallMatrix<T, N>> out(count);
+    for (auto& matrix : out)
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < N; ++j)
+                matrix.m[i][j] = rand() % 100;
+    return out;
+}
+
+// The same products with a runtime n, as the large kernels are written
+template <typename T, size_t N>
+void batch_mul_runtime(const SmallMatrix<T, N>* a, const SmallMatrix<T, N>* b, SmallMatrix<T, N>* c, size_t count,
+                       size_t n) {
+    for (size_t q = 0; q < count; ++q)
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < n; ++j) {
+                T sum = 0;
+                for (size_t k = 0; k < n; ++k)
+                    sum += a[q].m[i][k] * b[q].m[k][j];
+                c[q].m[i][j] = sum;
+            }
+}
+
+template <typename T, size_t N>
+static void BM_SmallMulRuntime(benchmark::State& state) {
+    PerfCounters perf;
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto a = random_small<T, N>(count), b = random_small<T, N>(count);
+    std::vector<SmallMatrix<T, N>> c(count);
+    size_t n = N;
+    benchmark::DoNotOptimize(n);
+
+    perf.start();
+    for (auto _ : state) {
+        batch_mul_runtime(a.data(), b.data(), c.data(), count, n);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename T, size_t N>
+static void BM_SmallMul(benchmark::State& state) {
+    PerfCounters perf;
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto a = random_small<T, N>(count), b = random_small<T, N>(count);
+    std::vector<SmallMatrix<T, N>> c(count);
+
+    perf.start();
+    for (auto _ : state) {
+        batch_mul(a.data(), b.data(), c.data(), count);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+template <typename T, size_t N>
+static void BM_SmallMulBatch(benchmark::State& state) {
+    PerfCounters perf;
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto a_rows = random_small<T, N>(count), b_rows = random_small<T, N>(count);
+    SmallMatrixBatch<T, N> a(a_rows.data(), count), b(b_rows.data(), count), c(count);
+
+    perf.start();
+    for (auto _ : state) {
+        batch_mul(a, b, c);
+        benchmark::DoNotOptimize(c.block(0));
+    }
+    perf.stop(state);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Strong scaling of the parallel GEMM: fixed n, state.range(0) threads.
+// Inputs and output are first-touched by the pool that multiplies them.
+template <size_t n, Schedule schedule>
+static void BM_GemmParallel(benchmark::State& state) {
+    PerfCounters perf;
+    ThreadPool pool(static_cast<unsigned>(state.range(0)));
+    auto a = Matrix<float>::uninitialized(n, n);
+    auto b = Matrix<float>::uninitialized(n, n);
+    auto c = Matrix<float>::uninitialized(n, n);
+    first_touch(a, pool);
+    first_touch(b, pool);
+    first_touch(c, pool);
+    fill_random(a);
+    fill_random(b);
+
+    perf.start();
+    for (auto _ : state) {
+        gemm_parallel(a, b, c, pool, schedule);
+        benchmark::DoNotOptimize(c.data());
+    }
+    perf.stop(state);
+    state.counters["flops"] = benchmark::Counter(2.0 * n * n * n * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// 1, 2, 4, ... up to and including the machine's hardware threads
+static void ThreadCounts(benchmark::internal::Benchmark* b) {
+    const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int t = 1; t < max_threads; t *= 2)
+        b->Arg(t);
+    b->Arg(max_threads);
+    b->ArgName("threads")->UseRealTime()->Unit(benchmark::kMillisecond);
 }
 
 // Define benchmarks with different matrix sizes
@@ -85,4 +461,135 @@ BENCHMARK_TEMPLATE(BM_Mul1, 2049);
 BENCHMARK_TEMPLATE(BM_Mul2, 2048);
 BENCHMARK_TEMPLATE(BM_Mul2, 2049);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK_TEMPLATE(BM_Mul2Matrix, 512);
+BENCHMARK_TEMPLATE(BM_Mul2Matrix, 2048);
+BENCHMARK_TEMPLATE(BM_Mul2Matrix, 2049);
+
+BENCHMARK_TEMPLATE(BM_Transpose, 1024, false);
+BENCHMARK_TEMPLATE(BM_Transpose, 1024, true);
+BENCHMARK_TEMPLATE(BM_Transpose, 2048, false);
+BENCHMARK_TEMPLATE(BM_Transpose, 2048, true);
+BENCHMARK_TEMPLATE(BM_Transpose, 2049, false);
+BENCHMARK_TEMPLATE(BM_Transpose, 2049, true);
+BENCHMARK_TEMPLATE(BM_Transpose, 4096, false);
+BENCHMARK_TEMPLATE(BM_Transpose, 4096, true);
+
+BENCHMARK_TEMPLATE(BM_Mul1Matrix, 2048, Padding::None);
+BENCHMARK_TEMPLATE(BM_Mul1Matrix, 2048, Padding::AvoidAliasing);
+
+BENCHMARK_TEMPLATE(BM_MulTiled, 128);
+BENCHMARK_TEMPLATE(BM_MulTiled, 256);
+BENCHMARK_TEMPLATE(BM_MulTiled, 512);
+BENCHMARK_TEMPLATE(BM_MulTiled, 2048);
+BENCHMARK_TEMPLATE(BM_MulTiled, 2049);
+
+BENCHMARK_TEMPLATE(BM_MulRecursive, 128);
+BENCHMARK_TEMPLATE(BM_MulRecursive, 256);
+BENCHMARK_TEMPLATE(BM_MulRecursive, 512);
+BENCHMARK_TEMPLATE(BM_MulRecursive, 2048);
+BENCHMARK_TEMPLATE(BM_MulRecursive, 2049);
+
+BENCHMARK_TEMPLATE(BM_MulStrassen, 512)->ArgName("crossover")->Arg(64)->Arg(128);
+BENCHMARK_TEMPLATE(BM_MulStrassen, 2048)->ArgName("crossover")->Arg(64)->Arg(128)->Arg(256);
+BENCHMARK_TEMPLATE(BM_MulStrassen, 2049)->ArgName("crossover")->Arg(64)->Arg(128)->Arg(256);
+
+BENCHMARK_TEMPLATE(BM_Gemm, float, 512);
+BENCHMARK_TEMPLATE(BM_Gemm, float, 1024);
+BENCHMARK_TEMPLATE(BM_Gemm, float, 2048);
+BENCHMARK_TEMPLATE(BM_Gemm, float, 2049);
+BENCHMARK_TEMPLATE(BM_Gemm, int, 512);
+BENCHMARK_TEMPLATE(BM_Gemm, int, 1024);
+BENCHMARK_TEMPLATE(BM_Gemm, int, 2048);
+BENCHMARK_TEMPLATE(BM_Gemm, int, 2049);
+BENCHMARK_TEMPLATE(BM_QGemm, int16_t, 512);
+BENCHMARK_TEMPLATE(BM_QGemm, int16_t, 1024);
+BENCHMARK_TEMPLATE(BM_QGemm, int16_t, 2048);
+BENCHMARK_TEMPLATE(BM_QGemm, int16_t, 2049);
+BENCHMARK_TEMPLATE(BM_QGemm, int8_t, 512);
+BENCHMARK_TEMPLATE(BM_QGemm, int8_t, 1024);
+BENCHMARK_TEMPLATE(BM_QGemm, int8_t, 2048);
+BENCHMARK_TEMPLATE(BM_QGemm, int8_t, 2049);
+
+BENCHMARK_TEMPLATE(BM_GemmTuned, float, 1024);
+BENCHMARK_TEMPLATE(BM_GemmTuned, float, 2048);
+BENCHMARK_TEMPLATE(BM_GemmTuned, float, 2049);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int32_t, 1024);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int32_t, 2048);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int32_t, 2049);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int16_t, 1024);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int16_t, 2048);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int16_t, 2049);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int8_t, 1024);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int8_t, 2048);
+BENCHMARK_TEMPLATE(BM_GemmTuned, int8_t, 2049);
+
+BENCHMARK_TEMPLATE(BM_SmallMulRuntime, float, 4)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMulRuntime, float, 8)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMulRuntime, float, 16)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMul, float, 4)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMul, float, 8)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMul, float, 16)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMulBatch, float, 4)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMulBatch, float, 8)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMulBatch, float, 16)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMul, int, 4)->Apply(SmallBatchSizes);
+BENCHMARK_TEMPLATE(BM_SmallMulBatch, int, 4)->Apply(SmallBatchSizes);
+
+BENCHMARK_TEMPLATE(BM_GemmParallel, 2048, Schedule::Static)->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_GemmParallel, 2048, Schedule::Dynamic)->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_GemmParallel, 4096, Schedule::Static)->Apply(ThreadCounts);
+BENCHMARK_TEMPLATE(BM_GemmParallel, 4096, Schedule::Dynamic)->Apply(ThreadCounts);
+
+// Size classes --autotune tunes: those of the BM_GemmTuned benchmarks
+static constexpr size_t kTunedSizes[] = {1024, 2048};
+
+template <typename T>
+static void autotune_sizes() {
+    for (size_t n : kTunedSizes) {
+        const TuneResult r = tuning.tune<T>(n, n, n);
+        std::cerr << "autotune " << tuning_detail::Kernel<T>::name << ' ' << n << ": mc=" << r.tiling.mc
+                  << " kc=" << r.tiling.kc << " nc=" << r.tiling.nc
+                  << (r.tiling.order == LoopOrder::ColumnsOuter ? " columns " : " rows ") << r.gops
+                  << " GOP/s, default " << r.default_gops << " GOP/s, " << r.candidates << " tilings\n";
+    }
+}
+
+// Google Benchmark's flags plus
+//   --tuning_file=PATH  tuning cache read at startup (mm_tuning.txt)
+//   --autotune          tune gemm and qgemm for this host first and save
+//                       the winners to the tuning file
+int main(int argc, char** argv) {
+    std::string tuning_file = "mm_tuning.txt";
+    bool autotune_first = false;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--autotune")
+            autotune_first = true;
+        else if (arg.rfind("--tuning_file=", 0) == 0)
+            tuning_file = arg.substr(std::string("--tuning_file=").size());
+        else
+            argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    tuning.load(tuning_file);
+    if (autotune_first) {
+        autotune_sizes<float>();
+        autotune_sizes<int32_t>();
+        autotune_sizes<int16_t>();
+        autotune_sizes<int8_t>();
+        if (!tuning.save(tuning_file)) {
+            std::cerr << "cannot write " << tuning_file << '\n';
+            return 1;
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,265 @@
+#include "matrix.h"
+#include "tiled_mul.h"
+#include "gemm.h"
+#include "parallel_gemm.h"
+#include "recursive_mul.h"
+#include "strassen.h"
+#include "small_matrix.h"
+#include "transpose.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <string>
+
+// Correctness checks for the kernels benchmarked in mm.cpp. Inputs are
+// small integers, so float products and sums are exact and every kernel
+// is compared with the naive product for equality.
+
+static bool all_passed = true;
+
+// ----------------------------------------------------
+// Simple "check" helper for pass/fail messages
+// ----------------------------------------------------
+static void check(bool condition, const std::string& test_name) {
+    if (!condition) {
+        std::cerr << "[FAILED] " << test_name << "\n";
+        all_passed = false;
+    } else {
+        std::cout << "[PASSED] " << test_name << "\n";
+    }
+}
+
+// Values in [-8, 8)
+template <typename T>
+static Matrix<T> random_matrix(size_t rows, size_t cols, std::mt19937& rng) {
+    Matrix<T> m(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            m(i, j) = static_cast<T>(static_cast<int>(rng() % 16) - 8);
+    return m;
+}
+
+template <typename T>
+static Matrix<T> naive_product(const Matrix<T>& a, const Matrix<T>& b) {
+    Matrix<T> c(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t j = 0; j < b.cols(); ++j) {
+            T sum = 0;
+            for (size_t k = 0; k < a.cols(); ++k)
+                sum += a(i, k) * b(k, j);
+            c(i, j) = sum;
+        }
+    return c;
+}
+
+// Empty, single, below and just above a micro-tile, and a few sizes that
+// leave partial tiles and partial blocks everywhere
+static const std::initializer_list<size_t> kDims = {0, 1, 5, 15, 33, 97, 130};
+
+// Output filled with garbage first, so a kernel that only accumulates or
+// skips an edge is caught
+template <typename T>
+static Matrix<T> garbage(size_t rows, size_t cols) {
+    Matrix<T> c(rows, cols);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            c(i, j) = static_cast<T>(99);
+    return c;
+}
+
+// ----------------------------------------------------
+// Cache-blocked multiply and packed GEMM
+// ----------------------------------------------------
+template <typename T>
+static void test_gemm(const std::string& name) {
+    std::mt19937 rng{1};
+    const Tiling tilings[] = {
+        gemm_default_tiling(),
+        Tiling{1, 1, 1},
+        Tiling{7, 3, 5},
+        Tiling{gemm_detail::kMr, 16, gemm_detail::kNr, LoopOrder::RowsOuter},
+        Tiling{50, 9, 40, LoopOrder::RowsOuter},
+    };
+    bool tiled_ok = true;
+    bool gemm_ok = true;
+    for (size_t m : kDims)
+        for (size_t k : kDims)
+            for (size_t n : kDims) {
+                const auto a = random_matrix<T>(m, k, rng);
+                const auto b = random_matrix<T>(k, n, rng);
+                const auto expected = naive_product(a, b);
+                for (const Tiling& t : tilings) {
+                    auto c = garbage<T>(m, n);
+                    mul_tiled(a, b, c, t);
+                    tiled_ok = tiled_ok && c == expected;
+                    c = garbage<T>(m, n);
+                    gemm(a, b, c, t);
+                    gemm_ok = gemm_ok && c == expected;
+                }
+            }
+    check(tiled_ok, "mul_tiled/" + name);
+    check(gemm_ok, "gemm/" + name);
+}
+
+// ----------------------------------------------------
+// Parallel GEMM: both schedules, more tiles than workers and fewer
+// ----------------------------------------------------
+static void test_gemm_parallel() {
+    std::mt19937 rng{2};
+    ThreadPool pool(3, false);
+    const Tiling tilings[] = {gemm_default_tiling(), Tiling{7, 3, 5}, Tiling{50, 9, 40, LoopOrder::RowsOuter}};
+    bool ok = true;
+    for (size_t m : kDims)
+        for (size_t k : kDims)
+            for (size_t n : kDims) {
+                const auto a = random_matrix<float>(m, k, rng);
+                const auto b = random_matrix<float>(k, n, rng);
+                const auto expected = naive_product(a, b);
+                for (const Tiling& t : tilings)
+                    for (Schedule schedule : {Schedule::Static, Schedule::Dynamic}) {
+                        auto c = garbage<float>(m, n);
+                        gemm_parallel(a, b, c, pool, schedule, t);
+                        ok = ok && c == expected;
+                    }
+            }
+
+    // Wide enough for many column tiles per worker
+    const auto a = random_matrix<float>(300, 70, rng);
+    const auto b = random_matrix<float>(70, 1100, rng);
+    const auto expected = naive_product(a, b);
+    for (Schedule schedule : {Schedule::Static, Schedule::Dynamic}) {
+        auto c = garbage<float>(300, 1100);
+        gemm_parallel(a, b, c, pool, schedule, Tiling{28, 32, 64});
+        ok = ok && c == expected;
+    }
+    check(ok, "gemm_parallel");
+}
+
+// ----------------------------------------------------
+// Recursive and Strassen multiplies: bases, crossovers, odd dimensions
+// at every level, and one scratch reused across shapes
+// ----------------------------------------------------
+template <typename T>
+static void test_recursive_strassen(const std::string& name) {
+    std::mt19937 rng{3};
+    bool recursive_ok = true;
+    bool strassen_ok = true;
+    StrassenScratch<T> reused(1, 1, 1, 8);
+    for (size_t m : kDims)
+        for (size_t k : kDims)
+            for (size_t n : kDims) {
+                const auto a = random_matrix<T>(m, k, rng);
+                const auto b = random_matrix<T>(k, n, rng);
+                const auto expected = naive_product(a, b);
+                for (size_t base : {1, 7, 64}) {
+                    auto c = garbage<T>(m, n);
+                    mul_recursive(a, b, c, base);
+                    recursive_ok = recursive_ok && c == expected;
+                }
+                for (size_t crossover : {4, 16, 128}) {
+                    auto c = garbage<T>(m, n);
+                    mul_strassen(a, b, c, crossover);
+                    strassen_ok = strassen_ok && c == expected;
+                }
+                auto c = garbage<T>(m, n);
+                mul_strassen(a, b, c, reused);
+                strassen_ok = strassen_ok && c == expected && reused.crossover() == 8;
+            }
+
+    // Several levels with an odd edge at each: 257 -> 128 -> 64 ...
+    const auto a = random_matrix<T>(257, 255, rng);
+    const auto b = random_matrix<T>(255, 259, rng);
+    const auto expected = naive_product(a, b);
+    StrassenScratch<T> scratch(257, 255, 259, 16);
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        auto c = garbage<T>(257, 259);
+        mul_strassen(a, b, c, scratch);
+        strassen_ok = strassen_ok && c == expected && scratch.levels() == 4;
+    }
+    check(recursive_ok, "mul_recursive/" + name);
+    check(strassen_ok, "mul_strassen/" + name);
+}
+
+// ----------------------------------------------------
+// Small fixed-size matrices: mul_small and both batch layouts, with a
+// partial last block in the interleaved one
+// ----------------------------------------------------
+template <typename T, size_t N>
+static void test_small(const std::string& name) {
+    std::mt19937 rng{4};
+    constexpr size_t lanes = SmallMatrixBatch<T, N>::kLanes;
+    bool ok = true;
+    for (size_t count : {size_t{1}, lanes - 1, lanes, 3 * lanes + 1}) {
+        std::vector<SmallMatrix<T, N>> a(count), b(count), c(count), expected(count);
+        for (size_t q = 0; q < count; ++q) {
+            const auto ma = random_matrix<T>(N, N, rng);
+            const auto mb = random_matrix<T>(N, N, rng);
+            const auto mc = naive_product(ma, mb);
+            for (size_t i = 0; i < N; ++i)
+                for (size_t j = 0; j < N; ++j) {
+                    a[q].m[i][j] = ma(i, j);
+                    b[q].m[i][j] = mb(i, j);
+                    expected[q].m[i][j] = mc(i, j);
+                }
+        }
+
+        for (size_t q = 0; q < count; ++q) {
+            SmallMatrix<T, N> single;
+            mul_small(a[q], b[q], single);
+            ok = ok && single == expected[q];
+        }
+        batch_mul(a.data(), b.data(), c.data(), count);
+        for (size_t q = 0; q < count; ++q)
+            ok = ok && c[q] == expected[q];
+
+        const SmallMatrixBatch<T, N> ba(a.data(), count), bb(b.data(), count);
+        SmallMatrixBatch<T, N> bc(count);
+        batch_mul(ba, bb, bc);
+        for (size_t q = 0; q < count; ++q)
+            ok = ok && bc.get(q) == expected[q];
+    }
+    check(ok, "small_matrix/" + name + "/" + std::to_string(N));
+}
+
+// ----------------------------------------------------
+// Blocked transpose: 4-byte elements take the 8 x 8 AVX tiles, others the
+// scalar ones; sizes leave partial tiles and partial blocks
+// ----------------------------------------------------
+template <typename T>
+static void test_transpose(const std::string& name) {
+    std::mt19937 rng{5};
+    bool ok = true;
+    for (size_t rows : {0, 1, 7, 8, 9, 64, 65, 130})
+        for (size_t cols : {0, 1, 7, 8, 9, 64, 65, 200}) {
+            const auto src = random_matrix<T>(rows, cols, rng);
+            auto dst = garbage<T>(cols, rows);
+            transpose(src, dst);
+            for (size_t i = 0; i < rows; ++i)
+                for (size_t j = 0; j < cols; ++j)
+                    ok = ok && dst(j, i) == src(i, j);
+            ok = ok && transposed(src) == dst;
+        }
+    check(ok, "transpose/" + name);
+}
+
+int main() {
+    test_gemm<float>("float");
+    test_gemm<int32_t>("int32");
+    test_gemm_parallel();
+    test_recursive_strassen<float>("float");
+    test_recursive_strassen<int>("int");
+    test_small<float, 4>("float");
+    test_small<float, 8>("float");
+    test_small<float, 16>("float");
+    test_small<int, 4>("int");
+    test_small<int, 7>("int");
+    test_transpose<float>("float");
+    test_transpose<int32_t>("int32");
+    test_transpose<double>("double");
+    test_transpose<int8_t>("int8");
+    return all_passed ? 0 : 1;
+}
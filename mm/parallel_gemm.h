@@ -0,0 +1,120 @@
+#pragma once
+
+#include "gemm.h"
+#include "matrix.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// ----------------------------------------------------
+// Multithreaded GEMM
+// ----------------------------------------------------
+//
+// c is cut into a grid of output tiles, about four per worker, each a
+// multiple of the gemm blocks (make_tile_grid). Each tile is an
+// independent gemm_tile call with the worker's own packing buffers; the
+// only shared data are a and b, which are read-only.
+//
+// Schedule::Static hands worker w the w-th contiguous run of tiles in
+// row-major order, i.e. roughly rows [w * m / W, (w + 1) * m / W) of c and
+// a. first_touch() writes exactly those rows from the same worker, so on a
+// NUMA machine the pages a worker reads and writes sit on its own node
+// (the pool pins workers, so they stay there). b is read by everyone;
+// first_touch spreads its rows over all workers, i.e. over all nodes.
+//
+// Schedule::Dynamic hands out tiles from a shared counter instead, which
+// balances better when cores run at different speeds or are shared, at the
+// price of the locality above.
+enum class Schedule {
+    Static,
+    Dynamic,
+};
+
+namespace gemm_detail {
+
+struct TileGrid {
+    size_t tile_rows;
+    size_t tile_cols;
+    size_t row_tiles;
+    size_t col_tiles;
+
+    size_t count() const { return row_tiles * col_tiles; }
+};
+
+// Each tile packs its own rows of a and columns of b, so a tile row packs
+// all of b's columns once and a tile column all of a's rows once: keep both
+// counts near sqrt(tiles). One worker gets one tile, i.e. plain gemm.
+inline TileGrid make_tile_grid(size_t m, size_t n, unsigned workers, const Tiling& t) {
+    const size_t wanted = workers > 1 ? 4 * size_t{workers} : 1;
+    size_t row_tiles = 1;
+    while (row_tiles * row_tiles < wanted)
+        ++row_tiles;
+    row_tiles = std::min(row_tiles, std::max<size_t>(1, (m + t.mc - 1) / t.mc));
+
+    TileGrid grid;
+    grid.tile_rows = round_up((m + row_tiles - 1) / row_tiles, t.mc);
+    grid.row_tiles = std::max<size_t>(1, (m + grid.tile_rows - 1) / grid.tile_rows);
+    const size_t wanted_cols = (wanted + grid.row_tiles - 1) / grid.row_tiles;
+    // Narrower than a few slivers and the packing of a dominates
+    grid.tile_cols = std::max(4 * kNr, round_up((n + wanted_cols - 1) / wanted_cols, kNr));
+    grid.col_tiles = std::max<size_t>(1, (n + grid.tile_cols - 1) / grid.tile_cols);
+    return grid;
+}
+
+} // namespace gemm_detail
+
+// Zeroes rows [w * rows / W, (w + 1) * rows / W) from worker w, so their
+// pages are allocated next to the worker that will use them. Use it on a
+// Matrix::uninitialized before the first gemm_parallel on the same pool.
+template <typename T>
+void first_touch(Matrix<T>& m, ThreadPool& pool) {
+    const size_t workers = pool.size();
+    pool.run([&](unsigned w) {
+        const size_t begin = m.rows() * w / workers;
+        const size_t end = m.rows() * (w + 1) / workers;
+        if (begin < end)
+            std::fill(m[begin], m[end - 1] + m.stride(), T{});
+    });
+}
+
+template <typename T>
+void gemm_parallel(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, ThreadPool& pool,
+                   Schedule schedule = Schedule::Static, const Tiling& tiling = gemm_default_tiling()) {
+    using namespace gemm_detail;
+
+    const size_t m = a.rows();
+    const size_t n = b.cols();
+    if (m == 0 || n == 0)
+        return;
+    if (a.cols() == 0) {
+        gemm(a, b, c, tiling);
+        return;
+    }
+
+    const Tiling t = normalize(fit(tiling, m, a.cols(), n));
+    const TileGrid grid = make_tile_grid(m, n, pool.size(), t);
+    const size_t tiles = grid.count();
+    const size_t workers = pool.size();
+    std::atomic<size_t> next{0};
+
+    pool.run([&](unsigned w) {
+        PackBuffers<T> buffers(t, grid.tile_cols);
+        auto compute = [&](size_t tile) {
+            const size_t row0 = tile / grid.col_tiles * grid.tile_rows;
+            const size_t col0 = tile % grid.col_tiles * grid.tile_cols;
+            if (row0 < m && col0 < n)
+                gemm_tile(a, b, c, row0, std::min(grid.tile_rows, m - row0), col0,
+                          std::min(grid.tile_cols, n - col0), t, buffers);
+        };
+
+        if (schedule == Schedule::Static) {
+            for (size_t tile = tiles * w / workers; tile < tiles * (w + 1) / workers; ++tile)
+                compute(tile);
+        } else {
+            for (size_t tile; (tile = next.fetch_add(1, std::memory_order_relaxed)) < tiles;)
+                compute(tile);
+        }
+    });
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "gemm.h"
+#include "matrix.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------
+// Quantized GEMM: int8 / int16 inputs, int32 output
+// ----------------------------------------------------
+//
+// c = a * b with a and b int8_t or int16_t and every product accumulated
+// in int32_t. Same blocking as gemm (packed kc x nc panels of b, mc x kc
+// blocks of a, MR x NR register tile); what changes is the packing and
+// the multiply in the micro-kernel. Along k, G consecutive inputs are
+// packed into one 32-bit lane, and one instruction multiplies G pairs and
+// adds them into the int32 accumulator:
+//
+//   int16              G = 2   vpmaddwd + vpaddd, or vpdpwssd (VNNI)
+//   int8 with VNNI     G = 4   vpdpbusd
+//   int8 otherwise     G = 2   widened to int16 while packing, then as
+//                              int16
+//
+// vpdpbusd multiplies unsigned by signed bytes, so a is packed as
+// a + 128 and the kernel subtracts 128 * (column sum of b) at the end.
+// vpmaddubsw, the pre-VNNI byte multiply, is not used: it saturates the
+// sum of two products at int16, so it is not exact for full-range int8.
+//
+// Accumulation wraps modulo 2^32 in every path (the instructions above
+// do not saturate), so results are bit-exact against qgemm_reference for
+// any inputs, including the few int16 inputs whose sums do overflow.
+
+namespace qgemm_detail {
+
+#if defined(__AVX512BW__)
+
+struct Lanes {
+    using reg = __m512i;
+    static constexpr size_t width = 16;
+    static reg zero() { return _mm512_setzero_si512(); }
+    static reg load(const void* p) { return _mm512_load_si512(p); }
+    static reg loadu(const int32_t* p) { return _mm512_loadu_si512(p); }
+    static void storeu(int32_t* p, reg v) { _mm512_storeu_si512(p, v); }
+    static reg add(reg a, reg b) { return _mm512_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm512_sub_epi32(a, b); }
+    static reg broadcast(const void* p) {
+        int32_t x;
+        std::memcpy(&x, p, sizeof(x));
+        return _mm512_set1_epi32(x);
+    }
+    // acc + a0 * b0 + a1 * b1 per lane, int16 pairs
+    static reg madd16(reg acc, reg a, reg b) {
+#if defined(__AVX512VNNI__)
+        return _mm512_dpwssd_epi32(acc, a, b);
+#else
+        return _mm512_add_epi32(acc, _mm512_madd_epi16(a, b));
+#endif
+    }
+#if defined(__AVX512VNNI__)
+    // acc + sum of four u8 * s8 per lane
+    static reg madd8(reg acc, reg a, reg b) { return _mm512_dpbusd_epi32(acc, a, b); }
+#endif
+};
+
+inline constexpr size_t kMr = 14;
+inline constexpr size_t kNr = 32;
+#if defined(__AVX512VNNI__)
+inline constexpr bool kHasU8S8 = true;
+#else
+inline constexpr bool kHasU8S8 = false;
+#endif
+
+#elif defined(__AVX2__)
+
+struct Lanes {
+    using reg = __m256i;
+    static constexpr size_t width = 8;
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg load(const void* p) { return _mm256_load_si256(static_cast<const __m256i*>(p)); }
+    static reg loadu(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storeu(int32_t* p, reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi32(a, b); }
+    static reg broadcast(const void* p) {
+        int32_t x;
+        std::memcpy(&x, p, sizeof(x));
+        return _mm256_set1_epi32(x);
+    }
+    static reg madd16(reg acc, reg a, reg b) { return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b)); }
+};
+
+inline constexpr size_t kMr = 6;
+inline constexpr size_t kNr = 16;
+inline constexpr bool kHasU8S8 = false;
+
+#else
+
+// One lane, kept as uint32_t so that wrap-around is defined
+struct Lanes {
+    using reg = uint32_t;
+    static constexpr size_t width = 1;
+    static reg zero() { return 0; }
+    static reg load(const void* p) { return broadcast(p); }
+    static reg loadu(const int32_t* p) { return static_cast<uint32_t>(*p); }
+    static void storeu(int32_t* p, reg v) { *p = static_cast<int32_t>(v); }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg broadcast(const void* p) {
+        uint32_t x;
+        std::memcpy(&x, p, sizeof(x));
+        return x;
+    }
+    static reg madd16(reg acc, reg a, reg b) {
+        int16_t av[2], bv[2];
+        std::memcpy(av, &a, sizeof(av));
+        std::memcpy(bv, &b, sizeof(bv));
+        return acc + static_cast<uint32_t>(av[0] * bv[0]) + static_cast<uint32_t>(av[1] * bv[1]);
+    }
+};
+
+inline constexpr size_t kMr = 4;
+inline constexpr size_t kNr = 4;
+inline constexpr bool kHasU8S8 = false;
+
+#endif
+
+// How T is laid out in the packed panels
+template <typename T>
+struct Format {
+    static_assert(std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>, "qgemm supports int8_t and int16_t");
+
+    // int8 through u8 x s8 dot products, a biased by +128
+    static constexpr bool kBiased = std::is_same_v<T, int8_t> && kHasU8S8;
+    using A = std::conditional_t<kBiased, uint8_t, int16_t>;
+    using B = std::conditional_t<kBiased, int8_t, int16_t>;
+    // k values per 32-bit lane
+    static constexpr size_t kGroup = sizeof(int32_t) / sizeof(B);
+    static constexpr int32_t kBias = 128;
+
+    static A pack_a(T x) { return kBiased ? static_cast<A>(x + kBias) : static_cast<A>(x); }
+};
+
+// kc x nc block of b -> NR-wide slivers. Within a sliver, group g of G
+// rows of b is NR lanes of G consecutive-k values. With a biased format
+// colsum receives kBias * (sum of each column over the block).
+template <typename T>
+void pack_b(const Matrix<T>& b, size_t pc, size_t kc, size_t jc, size_t nc, typename Format<T>::B* out,
+            int32_t* colsum) {
+    using F = Format<T>;
+    constexpr size_t G = F::kGroup;
+    const size_t groups = (kc + G - 1) / G;
+
+    for (size_t j = 0; j < nc; j += kNr) {
+        const size_t cols = std::min(kNr, nc - j);
+        uint32_t sums[kNr] = {};
+        for (size_t g = 0; g < groups; ++g) {
+            for (size_t e = 0; e < G; ++e) {
+                const size_t p = g * G + e;
+                typename F::B* dst = out + g * kNr * G + e;
+                size_t q = 0;
+                if (p < kc) {
+                    const T* src = b[pc + p] + jc + j;
+                    for (; q < cols; ++q) {
+                        dst[q * G] = src[q];
+                        if constexpr (F::kBiased)
+                            sums[q] += static_cast<uint32_t>(src[q]);
+                    }
+                }
+                for (; q < kNr; ++q)
+                    dst[q * G] = 0;
+            }
+        }
+        if constexpr (F::kBiased) {
+            for (size_t q = 0; q < kNr; ++q)
+                colsum[j + q] = static_cast<int32_t>(sums[q] * F::kBias);
+        }
+        out += groups * kNr * G;
+    }
+}
+
+// mc x kc block of a -> MR-tall slivers. Within a sliver, group g is MR
+// lanes of G consecutive-k values; padding is zero.
+template <typename T>
+void pack_a(const Matrix<T>& a, size_t ic, size_t mc, size_t pc, size_t kc, typename Format<T>::A* out) {
+    using F = Format<T>;
+    constexpr size_t G = F::kGroup;
+    const size_t groups = (kc + G - 1) / G;
+
+    for (size_t i = 0; i < mc; i += kMr) {
+        const size_t rows = std::min(kMr, mc - i);
+        for (size_t r = 0; r < kMr; ++r) {
+            const T* src = r < rows ? a[ic + i + r] + pc : nullptr;
+            for (size_t p = 0; p < groups * G; ++p)
+                out[(p / G) * kMr * G + r * G + p % G] = src && p < kc ? F::pack_a(src[p]) : 0;
+        }
+        out += groups * kMr * G;
+    }
+}
+
+// groups x MR block of a times groups x NR block of b; corr is the NR
+// column corrections of a biased format. V is a parameter only so that
+// V::madd8, which exists with VNNI alone, is looked up on instantiation.
+template <typename T, typename V = Lanes>
+inline void micro_kernel(size_t groups, const typename Format<T>::A* __restrict a,
+                         const typename Format<T>::B* __restrict b, const int32_t* corr, int32_t* c, size_t ldc,
+                         size_t rows, size_t cols, bool overwrite) {
+    using F = Format<T>;
+    constexpr size_t G = F::kGroup;
+    constexpr size_t nv = kNr / V::width;
+
+    typename V::reg acc[kMr][nv];
+#pragma GCC unroll 16
+    for (size_t i = 0; i < kMr; ++i)
+#pragma GCC unroll 4
+        for (size_t v = 0; v < nv; ++v)
+            acc[i][v] = V::zero();
+
+    for (size_t g = 0; g < groups; ++g) {
+        typename V::reg bv[nv];
+#pragma GCC unroll 4
+        for (size_t v = 0; v < nv; ++v)
+            bv[v] = V::load(b + v * V::width * G);
+#pragma GCC unroll 16
+        for (size_t i = 0; i < kMr; ++i) {
+            const typename V::reg ai = V::broadcast(a + i * G);
+#pragma GCC unroll 4
+            for (size_t v = 0; v < nv; ++v) {
+                if constexpr (F::kBiased)
+                    acc[i][v] = V::madd8(acc[i][v], ai, bv[v]);
+                else
+                    acc[i][v] = V::madd16(acc[i][v], ai, bv[v]);
+            }
+        }
+        a += kMr * G;
+        b += kNr * G;
+    }
+
+    if constexpr (F::kBiased) {
+#pragma GCC unroll 4
+        for (size_t v = 0; v < nv; ++v) {
+            const typename V::reg cv = V::loadu(corr + v * V::width);
+#pragma GCC unroll 16
+            for (size_t i = 0; i < kMr; ++i)
+                acc[i][v] = V::sub(acc[i][v], cv);
+        }
+    }
+
+    if (rows == kMr && cols == kNr) {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < kMr; ++i)
+#pragma GCC unroll 4
+            for (size_t v = 0; v < nv; ++v) {
+                int32_t* dst = c + i * ldc + v * V::width;
+                V::storeu(dst, overwrite ? acc[i][v] : V::add(V::loadu(dst), acc[i][v]));
+            }
+        return;
+    }
+
+    alignas(64) int32_t tile[kMr * kNr];
+    for (size_t i = 0; i < kMr; ++i)
+        for (size_t v = 0; v < nv; ++v)
+            V::storeu(tile + i * kNr + v * V::width, acc[i][v]);
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j) {
+            const uint32_t sum = static_cast<uint32_t>(tile[i * kNr + j]);
+            c[i * ldc + j] = static_cast<int32_t>(overwrite ? sum : static_cast<uint32_t>(c[i * ldc + j]) + sum);
+        }
+}
+
+// mc and nc rounded up to the micro-tile, kc to a multiple of 4 so that
+// every panel but the last holds whole groups
+inline Tiling normalize(const Tiling& tiling) {
+    return Tiling{gemm_detail::round_up(std::max<size_t>(tiling.mc, 1), kMr),
+                  gemm_detail::round_up(std::max<size_t>(tiling.kc, 1), 4),
+                  gemm_detail::round_up(std::max<size_t>(tiling.nc, 1), kNr), tiling.order};
+}
+
+} // namespace qgemm_detail
+
+// Block sizes for qgemm; the operands are a half or a quarter the size of
+// gemm's, so the depth of a panel doubles for the same cache footprint
+inline Tiling qgemm_default_tiling() {
+    return Tiling{qgemm_detail::kMr * 8, 768, 4096};
+}
+
+template <typename T>
+void qgemm(const Matrix<T>& a, const Matrix<T>& b, Matrix<int32_t>& c, const Tiling& tiling = qgemm_default_tiling()) {
+    using namespace qgemm_detail;
+    using F = Format<T>;
+    constexpr size_t G = F::kGroup;
+
+    const size_t m = a.rows();
+    const size_t n = b.cols();
+    const size_t depth = a.cols();
+    if (depth == 0) {
+        for (size_t i = 0; i < m; ++i)
+            std::fill(c[i], c[i] + n, 0);
+        return;
+    }
+
+    const Tiling t = normalize(gemm_detail::fit(tiling, m, depth, n));
+    const size_t ncap = std::min(t.nc, gemm_detail::round_up(n, kNr));
+    auto packed_a = make_aligned_array<typename F::A>(t.mc * t.kc);
+    auto packed_b = make_aligned_array<typename F::B>(t.kc * ncap);
+    auto colsum = make_aligned_array<int32_t>(ncap);
+
+    for (size_t jc = 0; jc < n; jc += t.nc) {
+        const size_t nb = std::min(t.nc, n - jc);
+        for (size_t pc = 0; pc < depth; pc += t.kc) {
+            const size_t kb = std::min(t.kc, depth - pc);
+            const size_t groups = (kb + G - 1) / G;
+            pack_b(b, pc, kb, jc, nb, packed_b.get(), colsum.get());
+            for (size_t ic = 0; ic < m; ic += t.mc) {
+                const size_t mb = std::min(t.mc, m - ic);
+                pack_a(a, ic, mb, pc, kb, packed_a.get());
+                auto tile = [&](size_t ir, size_t jr) {
+                    micro_kernel<T>(groups, packed_a.get() + ir * groups * G, packed_b.get() + jr * groups * G,
+                                    colsum.get() + jr, c[ic + ir] + jc + jr, c.stride(), std::min(kMr, mb - ir),
+                                    std::min(kNr, nb - jr), pc == 0);
+                };
+                if (t.order == LoopOrder::ColumnsOuter) {
+                    for (size_t jr = 0; jr < nb; jr += kNr)
+                        for (size_t ir = 0; ir < mb; ir += kMr)
+                            tile(ir, jr);
+                } else {
+                    for (size_t ir = 0; ir < mb; ir += kMr)
+                        for (size_t jr = 0; jr < nb; jr += kNr)
+                            tile(ir, jr);
+                }
+            }
+        }
+    }
+}
+
+// The definition qgemm is exact against: int32 sums of products, wrapping
+// modulo 2^32
+template <typename T>
+void qgemm_reference(const Matrix<T>& a, const Matrix<T>& b, Matrix<int32_t>& c) {
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t j = 0; j < b.cols(); ++j) {
+            uint32_t sum = 0;
+            for (size_t p = 0; p < a.cols(); ++p)
+                sum += static_cast<uint32_t>(int32_t{a(i, p)} * int32_t{b(p, j)});
+            c(i, j) = static_cast<int32_t>(sum);
+        }
+}
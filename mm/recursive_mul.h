@@ -0,0 +1,111 @@
+#pragma once
+
+#include "matrix.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// ----------------------------------------------------
+// Cache-oblivious recursive multiply
+// ----------------------------------------------------
+//
+// c = a * b by halving the largest of the three dimensions (rows of a,
+// depth, columns of b) until all of them are at most `base`:
+//
+//   split m:  c_top    = a_top * b           c_bottom = a_bottom * b
+//   split n:  c_left   = a * b_left          c_right  = a * b_right
+//   split k:  c       += a_left * b_top      c       += a_right * b_bottom
+//
+// Somewhere on the way down the three blocks fit in each level of the
+// cache, whatever its size, so unlike mul_tiled nothing is tuned to a
+// particular machine except the base case, which only has to be small
+// enough for L1 and large enough to amortize the calls. Splitting the
+// largest dimension keeps the blocks close to square for any shape, 2049
+// included; split points are rounded down to a cache line so column
+// blocks start on one. 64 is the best base on a 48 KB L1 for int.
+
+namespace recursive_detail {
+
+// c += a * b. A strip of kStrip elements of a row of c stays in registers
+// for the whole depth, so the inner loop is one load of b per multiply-add
+// instead of the load + store of c as well that the axpy form pays.
+template <typename T>
+void mul_add_base(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c) {
+    constexpr size_t kStrip = 64;
+    for (size_t i = 0; i < a.rows; ++i) {
+        const T* ai = a[i];
+        T* ci = c[i];
+        size_t j0 = 0;
+        for (; j0 + kStrip <= b.cols; j0 += kStrip) {
+            T acc[kStrip] = {};
+            for (size_t p = 0; p < a.cols; ++p) {
+                const T aip = ai[p];
+                const T* bp = b[p] + j0;
+                for (size_t j = 0; j < kStrip; ++j)
+                    acc[j] += aip * bp[j];
+            }
+            for (size_t j = 0; j < kStrip; ++j)
+                ci[j0 + j] += acc[j];
+        }
+        for (size_t p = 0; p < a.cols; ++p) {
+            const T aip = ai[p];
+            const T* __restrict bp = b[p];
+            T* __restrict cij = ci;
+            for (size_t j = j0; j < b.cols; ++j)
+                cij[j] += aip * bp[j];
+        }
+    }
+}
+
+template <typename T>
+size_t split_point(size_t extent) {
+    constexpr size_t line = Matrix<T>::kLineElems;
+    const size_t half = extent / 2;
+    return half >= line ? half / line * line : half;
+}
+
+// c += a * b
+template <typename T>
+void mul_add_recursive(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, size_t base) {
+    const size_t m = a.rows;
+    const size_t k = a.cols;
+    const size_t n = b.cols;
+    if (m <= base && k <= base && n <= base) {
+        mul_add_base(a, b, c);
+        return;
+    }
+
+    if (m >= k && m >= n) {
+        const size_t h = split_point<T>(m);
+        mul_add_recursive(a.block(0, 0, h, k), b, c.block(0, 0, h, n), base);
+        mul_add_recursive(a.block(h, 0, m - h, k), b, c.block(h, 0, m - h, n), base);
+    } else if (n >= k) {
+        const size_t h = split_point<T>(n);
+        mul_add_recursive(a, b.block(0, 0, k, h), c.block(0, 0, m, h), base);
+        mul_add_recursive(a, b.block(0, h, k, n - h), c.block(0, h, m, n - h), base);
+    } else {
+        const size_t h = split_point<T>(k);
+        mul_add_recursive(a.block(0, 0, m, h), b.block(0, 0, h, n), c, base);
+        mul_add_recursive(a.block(0, h, m, k - h), b.block(h, 0, k - h, n), c, base);
+    }
+}
+
+template <typename T>
+void fill_zero(MatrixView<T> c) {
+    for (size_t i = 0; i < c.rows; ++i)
+        std::fill(c[i], c[i] + c.cols, T{});
+}
+
+} // namespace recursive_detail
+
+// c = a * b on views; base is the largest block edge handled directly
+template <typename T>
+void mul_recursive(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, size_t base = 64) {
+    recursive_detail::fill_zero(c);
+    recursive_detail::mul_add_recursive(a, b, c, std::max<size_t>(base, 1));
+}
+
+template <typename T>
+void mul_recursive(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, size_t base = 64) {
+    mul_recursive(a.view(), b.view(), c.view(), base);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "gemm.h"
+#include "matrix.h"
+
+#include <cstddef>
+#include <cstring>
+
+// ----------------------------------------------------
+// Small fixed-size matrices
+// ----------------------------------------------------
+//
+// For millions of 4x4 .. 16x16 products the overheads that do not matter
+// at n = 2048 are the whole cost: loop control, index arithmetic, a
+// runtime n the compiler cannot unroll on. Everything here takes N as a
+// template argument, so the loops below unroll completely and the
+// operands stay in registers.
+//
+// Two layouts:
+//
+//   SmallMatrix<T, N>       one matrix, row-major (array of structures).
+//                           mul_small keeps b in N row registers and
+//                           builds each row of c from N broadcasts of a,
+//                           so SIMD runs along a row, N lanes wide.
+//
+//   SmallMatrixBatch<T, N>  L matrices interleaved (L = SIMD width, 16 for
+//                           float on AVX-512): element (i, j) of matrices
+//                           q .. q + L - 1 is one aligned vector. The
+//                           product is then N^3 vertical multiply-adds
+//                           with every lane a different matrix: no
+//                           broadcasts, no shuffles, and full width even
+//                           for N = 4.
+
+template <typename T, size_t N>
+struct alignas(64) SmallMatrix {
+    T m[N][N];
+
+    bool operator==(const SmallMatrix& other) const { return std::memcmp(m, other.m, sizeof(m)) == 0; }
+    bool operator!=(const SmallMatrix& other) const { return !(*this == other); }
+};
+
+// c = a * b
+template <typename T, size_t N>
+inline void mul_small(const SmallMatrix<T, N>& a, const SmallMatrix<T, N>& b, SmallMatrix<T, N>& c) {
+#pragma GCC unroll 16
+    for (size_t i = 0; i < N; ++i) {
+        T row[N] = {};
+#pragma GCC unroll 16
+        for (size_t k = 0; k < N; ++k)
+#pragma GCC unroll 16
+            for (size_t j = 0; j < N; ++j)
+                row[j] += a.m[i][k] * b.m[k][j];
+#pragma GCC unroll 16
+        for (size_t j = 0; j < N; ++j)
+            c.m[i][j] = row[j];
+    }
+}
+
+// c[q] = a[q] * b[q] for q < count
+template <typename T, size_t N>
+void batch_mul(const SmallMatrix<T, N>* a, const SmallMatrix<T, N>* b, SmallMatrix<T, N>* c, size_t count) {
+    for (size_t q = 0; q < count; ++q)
+        mul_small(a[q], b[q], c[q]);
+}
+
+template <typename T, size_t N>
+class SmallMatrixBatch {
+public:
+    using Lanes = gemm_detail::Simd<T>;
+    static constexpr size_t kLanes = Lanes::width;
+    static constexpr size_t kBlockElems = N * N * kLanes;
+
+    explicit SmallMatrixBatch(size_t count = 0)
+        : count_(count), blocks_((count + kLanes - 1) / kLanes), data_(make_aligned_array<T>(blocks_ * kBlockElems)) {
+        if (data_)
+            std::memset(data_.get(), 0, blocks_ * kBlockElems * sizeof(T));
+    }
+
+    // Interleaves count row-major matrices
+    SmallMatrixBatch(const SmallMatrix<T, N>* matrices, size_t count) : SmallMatrixBatch(count) {
+        for (size_t q = 0; q < count; ++q)
+            set(q, matrices[q]);
+    }
+
+    size_t size() const { return count_; }
+    size_t blocks() const { return blocks_; }
+
+    // kLanes interleaved matrices, N * N vectors of kLanes elements
+    T* block(size_t index) { return data_.get() + index * kBlockElems; }
+    const T* block(size_t index) const { return data_.get() + index * kBlockElems; }
+
+    T& operator()(size_t q, size_t i, size_t j) { return block(q / kLanes)[(i * N + j) * kLanes + q % kLanes]; }
+    const T& operator()(size_t q, size_t i, size_t j) const {
+        return block(q / kLanes)[(i * N + j) * kLanes + q % kLanes];
+    }
+
+    SmallMatrix<T, N> get(size_t q) const {
+        SmallMatrix<T, N> out;
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < N; ++j)
+                out.m[i][j] = (*this)(q, i, j);
+        return out;
+    }
+
+    void set(size_t q, const SmallMatrix<T, N>& matrix) {
+        for (size_t i = 0; i < N; ++i)
+            for (size_t j = 0; j < N; ++j)
+                (*this)(q, i, j) = matrix.m[i][j];
+    }
+
+private:
+    size_t count_;
+    size_t blocks_;
+    AlignedArray<T> data_;
+};
+
+// c[q] = a[q] * b[q] for every matrix of the batch; c must be as large as a
+// and b. A partial last block multiplies its zero padding too, which is
+// cheaper than a scalar tail.
+template <typename T, size_t N>
+void batch_mul(const SmallMatrixBatch<T, N>& a, const SmallMatrixBatch<T, N>& b, SmallMatrixBatch<T, N>& c) {
+    using V = typename SmallMatrixBatch<T, N>::Lanes;
+    constexpr size_t L = SmallMatrixBatch<T, N>::kLanes;
+
+    for (size_t blk = 0; blk < a.blocks(); ++blk) {
+        const T* __restrict ab = a.block(blk);
+        const T* __restrict bb = b.block(blk);
+        T* __restrict cb = c.block(blk);
+        for (size_t i = 0; i < N; ++i) {
+            typename V::reg acc[N];
+#pragma GCC unroll 16
+            for (size_t j = 0; j < N; ++j)
+                acc[j] = V::zero();
+            // k stays a loop: unrolled too, GCC keeps N^2 addresses of b
+            // live and spills them
+            for (size_t k = 0; k < N; ++k) {
+                const typename V::reg aik = V::load(ab + (i * N + k) * L);
+                const T* bk = bb + k * N * L;
+#pragma GCC unroll 16
+                for (size_t j = 0; j < N; ++j)
+                    acc[j] = V::madd(aik, V::load(bk + j * L), acc[j]);
+            }
+#pragma GCC unroll 16
+            for (size_t j = 0; j < N; ++j)
+                V::storeu(cb + (i * N + j) * L, acc[j]);
+        }
+    }
+}
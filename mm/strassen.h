@@ -0,0 +1,238 @@
+#pragma once
+
+#include "matrix.h"
+#include "recursive_mul.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// ----------------------------------------------------
+// Strassen multiply
+// ----------------------------------------------------
+//
+// With a, b and c cut into 2 x 2 blocks, seven block products instead of
+// eight:
+//
+//   M1 = (A11 + A22)(B11 + B22)     C11 = M1 + M4 - M5 + M7
+//   M2 = (A21 + A22) B11            C12 = M3 + M5
+//   M3 = A11 (B12 - B22)            C21 = M2 + M4
+//   M4 = A22 (B21 - B11)            C22 = M1 - M2 + M3 + M6
+//   M5 = (A11 + A12) B22
+//   M6 = (A21 - A11)(B11 + B12)
+//   M7 = (A12 - A22)(B21 + B22)
+//
+// applied recursively until every block edge is at most the crossover,
+// where mul_recursive takes over. Each level trades one eighth of the
+// multiplies for 18 block additions, which only pays off while the blocks
+// are large, hence the crossover. For float the result is less accurate
+// than the classical product; for int it is exact as long as the operand
+// sums, which are larger than any single element, do not overflow.
+//
+// All memory is allocated up front in a StrassenScratch: per level one
+// block for the left operand sum, one for the right and one for the
+// product, each a quarter of the level above, so together about a third
+// of a, b and c. Levels are computed one product at a time and the
+// product is folded into the c blocks straight away, so one set per level
+// is enough.
+//
+// Odd dimensions are peeled rather than padded: a level multiplies the
+// even part with the seven products and adds the last row, column and
+// depth slice with plain O(n^2) loops. Block edges at level l are then
+// exactly d >> l, 2049 runs the same leaves as 2048, and nothing is
+// copied.
+template <typename T>
+class StrassenScratch {
+public:
+    StrassenScratch(size_t m, size_t k, size_t n, size_t crossover = 128)
+        : m_(m), k_(k), n_(n), crossover_(std::max<size_t>(crossover, 1)) {
+        while ((m >> levels_) > crossover_ || (k >> levels_) > crossover_ || (n >> levels_) > crossover_)
+            ++levels_;
+        for (size_t level = 1; level <= levels_; ++level) {
+            left_.emplace_back(m >> level, k >> level);
+            right_.emplace_back(k >> level, n >> level);
+            product_.emplace_back(m >> level, n >> level);
+        }
+    }
+
+    size_t crossover() const { return crossover_; }
+    size_t levels() const { return levels_; }
+
+    // Whether this scratch was made for an m x k by k x n product
+    bool fits(size_t m, size_t k, size_t n) const { return m == m_ && k == k_ && n == n_; }
+
+private:
+    template <typename U>
+    friend void mul_strassen(MatrixView<const U>, MatrixView<const U>, MatrixView<U>, StrassenScratch<U>&);
+
+    size_t m_;
+    size_t k_;
+    size_t n_;
+    size_t crossover_;
+    size_t levels_ = 0;
+    std::vector<Matrix<T>> left_;
+    std::vector<Matrix<T>> right_;
+    std::vector<Matrix<T>> product_;
+};
+
+namespace strassen_detail {
+
+// out = x + sign * y
+template <typename T>
+void combine(MatrixView<const T> x, MatrixView<const T> y, int sign, MatrixView<T> out) {
+    for (size_t i = 0; i < out.rows; ++i) {
+        const T* __restrict xi = x[i];
+        const T* __restrict yi = y[i];
+        T* __restrict oi = out[i];
+        if (sign > 0) {
+            for (size_t j = 0; j < out.cols; ++j)
+                oi[j] = xi[j] + yi[j];
+        } else {
+            for (size_t j = 0; j < out.cols; ++j)
+                oi[j] = xi[j] - yi[j];
+        }
+    }
+}
+
+// c = p (sign 0), c += p (sign 1) or c -= p (sign -1)
+template <typename T>
+void fold(MatrixView<const T> p, int sign, MatrixView<T> c) {
+    for (size_t i = 0; i < c.rows; ++i) {
+        const T* __restrict pi = p[i];
+        T* __restrict ci = c[i];
+        if (sign == 0) {
+            std::copy(pi, pi + c.cols, ci);
+        } else if (sign > 0) {
+            for (size_t j = 0; j < c.cols; ++j)
+                ci[j] += pi[j];
+        } else {
+            for (size_t j = 0; j < c.cols; ++j)
+                ci[j] -= pi[j];
+        }
+    }
+}
+
+// Adds what the even part m2 x k2 x n2 of c = a * b leaves out (run after
+// it, the depth slice is added on top): the last
+// depth slice if k is odd, then the last column and row of c if n or m is
+template <typename T>
+void peel(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, size_t m2, size_t k2, size_t n2) {
+    const size_t m = a.rows;
+    const size_t k = a.cols;
+    const size_t n = b.cols;
+    if (k2 < k) {
+        const T* __restrict bk = b[k2];
+        for (size_t i = 0; i < m2; ++i) {
+            const T aik = a[i][k2];
+            T* __restrict ci = c[i];
+            for (size_t j = 0; j < n2; ++j)
+                ci[j] += aik * bk[j];
+        }
+    }
+    if (n2 < n) {
+        for (size_t i = 0; i < m; ++i) {
+            T sum = 0;
+            for (size_t p = 0; p < k; ++p)
+                sum += a[i][p] * b[p][n2];
+            c[i][n2] = sum;
+        }
+    }
+    if (m2 < m) {
+        T* __restrict cm = c[m2];
+        std::fill(cm, cm + n2, T{});
+        for (size_t p = 0; p < k; ++p) {
+            const T amp = a[m2][p];
+            const T* __restrict bp = b[p];
+            for (size_t j = 0; j < n2; ++j)
+                cm[j] += amp * bp[j];
+        }
+    }
+}
+
+// c = a * b with levels - level Strassen levels to go
+template <typename T>
+void strassen(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, size_t level, size_t levels,
+              std::vector<Matrix<T>>& left, std::vector<Matrix<T>>& right, std::vector<Matrix<T>>& product) {
+    if (level == levels) {
+        mul_recursive(a, b, c);
+        return;
+    }
+
+    const size_t m = a.rows / 2;
+    const size_t k = a.cols / 2;
+    const size_t n = b.cols / 2;
+    const MatrixView<const T> a11 = a.block(0, 0, m, k), a12 = a.block(0, k, m, k);
+    const MatrixView<const T> a21 = a.block(m, 0, m, k), a22 = a.block(m, k, m, k);
+    const MatrixView<const T> b11 = b.block(0, 0, k, n), b12 = b.block(0, n, k, n);
+    const MatrixView<const T> b21 = b.block(k, 0, k, n), b22 = b.block(k, n, k, n);
+    const MatrixView<T> c11 = c.block(0, 0, m, n), c12 = c.block(0, n, m, n);
+    const MatrixView<T> c21 = c.block(m, 0, m, n), c22 = c.block(m, n, m, n);
+
+    const MatrixView<T> s = left[level].view();
+    const MatrixView<T> t = right[level].view();
+    const MatrixView<T> p = product[level].view();
+    auto multiply = [&](MatrixView<const T> x, MatrixView<const T> y) {
+        strassen(x, y, p, level + 1, levels, left, right, product);
+    };
+
+    combine(a11, a22, +1, s);
+    combine(b11, b22, +1, t);
+    multiply(s, t); // M1
+    fold<T>(p, 0, c11);
+    fold<T>(p, 0, c22);
+
+    combine(a21, a22, +1, s);
+    multiply(s, b11); // M2
+    fold<T>(p, 0, c21);
+    fold<T>(p, -1, c22);
+
+    combine(b12, b22, -1, t);
+    multiply(a11, t); // M3
+    fold<T>(p, 0, c12);
+    fold<T>(p, +1, c22);
+
+    combine(b21, b11, -1, t);
+    multiply(a22, t); // M4
+    fold<T>(p, +1, c11);
+    fold<T>(p, +1, c21);
+
+    combine(a11, a12, +1, s);
+    multiply(s, b22); // M5
+    fold<T>(p, -1, c11);
+    fold<T>(p, +1, c12);
+
+    combine(a21, a11, -1, s);
+    combine(b11, b12, +1, t);
+    multiply(s, t); // M6
+    fold<T>(p, +1, c22);
+
+    combine(a12, a22, -1, s);
+    combine(b21, b22, +1, t);
+    multiply(s, t); // M7
+    fold<T>(p, +1, c11);
+
+    peel(a, b, c, 2 * m, 2 * k, 2 * n);
+}
+
+} // namespace strassen_detail
+
+// c = a * b. A scratch made for other dimensions than a.rows x a.cols x
+// b.cols is rebuilt for these, with the same crossover.
+template <typename T>
+void mul_strassen(MatrixView<const T> a, MatrixView<const T> b, MatrixView<T> c, StrassenScratch<T>& scratch) {
+    if (!scratch.fits(a.rows, a.cols, b.cols))
+        scratch = StrassenScratch<T>(a.rows, a.cols, b.cols, scratch.crossover());
+    strassen_detail::strassen(a, b, c, 0, scratch.levels_, scratch.left_, scratch.right_, scratch.product_);
+}
+
+template <typename T>
+void mul_strassen(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, StrassenScratch<T>& scratch) {
+    mul_strassen(a.view(), b.view(), c.view(), scratch);
+}
+
+// One-off multiply; allocates a scratch for this call only
+template <typename T>
+void mul_strassen(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, size_t crossover = 128) {
+    StrassenScratch<T> scratch(a.rows(), a.cols(), b.cols(), crossover);
+    mul_strassen(a, b, c, scratch);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+// ----------------------------------------------------
+// Persistent, optionally pinned worker pool
+// ----------------------------------------------------
+//
+// run(body) calls body(worker) once on every worker, 0 .. size() - 1, and
+// returns when all of them are done. The threads live as long as the pool,
+// so a multiply pays for a wake-up, not a thread start.
+//
+// With pin = true worker w is bound to the w-th CPU this process may run on
+// (sched_getaffinity, so cpusets and taskset are respected), wrapping round
+// if there are more workers than CPUs. A worker then keeps its caches and,
+// on a NUMA box, its node: memory it touches first stays local to it.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = std::thread::hardware_concurrency(), bool pin = true) {
+        if (threads == 0)
+            threads = 1;
+        const std::vector<int> cpus = allowed_cpus();
+        workers_.reserve(threads);
+        for (unsigned w = 0; w < threads; ++w) {
+            workers_.emplace_back([this, w] { loop(w); });
+            if (pin && !cpus.empty()) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpus[w % cpus.size()], &set);
+                pthread_setaffinity_np(workers_.back().native_handle(), sizeof(set), &set);
+            }
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for (auto& t : workers_)
+            t.join();
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    // Not reentrant: one run() at a time, and not from inside a body
+    void run(const std::function<void(unsigned)>& body) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        body_ = &body;
+        pending_ = size();
+        ++generation_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return pending_ == 0; });
+        body_ = nullptr;
+    }
+
+private:
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if (CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    void loop(unsigned worker) {
+        size_t seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* body;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_)
+                    return;
+                seen = generation_;
+                body = body_;
+            }
+            (*body)(worker);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--pending_ == 0)
+                    done_.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(unsigned)>* body_ = nullptr;
+    size_t generation_ = 0;
+    unsigned pending_ = 0;
+    bool stopping_ = false;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "matrix.h"
+#include "tiling.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// ----------------------------------------------------
+// Cache-blocked multiply
+// ----------------------------------------------------
+//
+// c = a * b with three levels of blocking, outermost first:
+//
+//   nc  columns of b and c:  the kc x nc block of b is reused by every row
+//                            of a, so it should fit in L2
+//   kc  depth:               one row of c (nc elements) is updated kc times
+//                            in a row while it sits in L1
+//   mc  rows of a and c:     the mc x kc block of a is reused across the nc
+//                            columns
+//
+// The innermost loop is c[i][j..] += a[i][p] * b[p][j..], a contiguous
+// axpy over rows of b and c that the compiler vectorizes; nothing walks a
+// column.
+
+template <typename T>
+void mul_tiled(const Matrix<T>& a, const Matrix<T>& b, Matrix<T>& c, const Tiling& tiling = {}) {
+    const size_t n = a.rows();
+    const size_t depth = a.cols();
+    const size_t m = b.cols();
+
+    for (size_t i = 0; i < n; ++i)
+        std::fill(c[i], c[i] + m, T{});
+
+    for (size_t jc = 0; jc < m; jc += tiling.nc) {
+        const size_t nb = std::min(tiling.nc, m - jc);
+        for (size_t pc = 0; pc < depth; pc += tiling.kc) {
+            const size_t kb = std::min(tiling.kc, depth - pc);
+            for (size_t ic = 0; ic < n; ic += tiling.mc) {
+                const size_t mb = std::min(tiling.mc, n - ic);
+                for (size_t i = ic; i < ic + mb; ++i) {
+                    T* __restrict ci = c[i] + jc;
+                    const T* ai = a[i];
+                    for (size_t p = pc; p < pc + kb; ++p) {
+                        const T aip = ai[p];
+                        const T* __restrict bp = b[p] + jc;
+                        for (size_t j = 0; j < nb; ++j)
+                            ci[j] += aip * bp[j];
+                    }
+                }
+            }
+        }
+    }
+}
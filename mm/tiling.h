@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// ----------------------------------------------------
+// Block sizes of the blocked multiplies
+// ----------------------------------------------------
+//
+// mul_tiled and the packed GEMMs (gemm, qgemm, gemm_parallel) block the
+// same three loops: mc rows of a and c, kc of the depth, nc columns of b
+// and c. The defaults below are mul_tiled's; the packed GEMMs start from
+// gemm_default_tiling() / qgemm_default_tiling().
+
+// Order of the two loops around the micro-kernel of the packed GEMMs;
+// mul_tiled has no micro-kernel and ignores it.
+//
+//   ColumnsOuter  for each NR sliver of b, for each MR sliver of a: the
+//                 kc x NR sliver of b stays in L1, a is reread from L2
+//   RowsOuter     for each MR sliver of a, for each NR sliver of b: the
+//                 kc x MR sliver of a stays in L1, the kc x nc panel of b
+//                 is reread, so nc has to be small enough for L2
+enum class LoopOrder { ColumnsOuter, RowsOuter };
+
+struct Tiling {
+    size_t mc = 64;
+    size_t kc = 128;
+    size_t nc = 512;
+    LoopOrder order = LoopOrder::ColumnsOuter;
+};
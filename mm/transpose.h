@@ -0,0 +1,134 @@
+#pragma once
+
+#include "matrix.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------
+// Out-of-place cache-blocked transpose
+// ----------------------------------------------------
+//
+// dst = src^T, src untouched. The naive loop reads src along rows and
+// writes dst down a column, one element per cache line; with a power of
+// two stride those lines also share a handful of cache sets. Here the
+// matrix is walked in kBlock x kBlock blocks, small enough that the src
+// block and the dst block sit in L1 together (2 x 16 KB for 4-byte
+// elements), and each block in 8 x 8 tiles:
+//
+//   4-byte T with AVX   8 row loads, 24 unpack/shuffle/permute, 8 row
+//                       stores, all in ymm registers
+//   otherwise           scalar 8 x 8 copy
+//
+// Within a block the tiles go down the columns of src, so consecutive
+// tiles fill the same eight rows of dst left to right. Partial tiles at
+// the right and bottom edges are copied scalar.
+
+namespace transpose_detail {
+
+inline constexpr size_t kBlock = 64;
+inline constexpr size_t kTile = 8;
+
+#if defined(__AVX__)
+
+// 8 x 8 tile of 32-bit elements; element types only pass through
+inline void transpose_8x8_avx(const float* src, size_t src_stride, float* dst, size_t dst_stride) {
+    const __m256 r0 = _mm256_loadu_ps(src + 0 * src_stride);
+    const __m256 r1 = _mm256_loadu_ps(src + 1 * src_stride);
+    const __m256 r2 = _mm256_loadu_ps(src + 2 * src_stride);
+    const __m256 r3 = _mm256_loadu_ps(src + 3 * src_stride);
+    const __m256 r4 = _mm256_loadu_ps(src + 4 * src_stride);
+    const __m256 r5 = _mm256_loadu_ps(src + 5 * src_stride);
+    const __m256 r6 = _mm256_loadu_ps(src + 6 * src_stride);
+    const __m256 r7 = _mm256_loadu_ps(src + 7 * src_stride);
+
+    // Interleave pairs of rows: t0 = r0[0] r1[0] r0[1] r1[1] | r0[4] r1[4] ...
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    const __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    const __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    const __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    const __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+    // Pairs of pairs: s0 = column 0 of rows 0-3 | column 4 of rows 0-3
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    // Join the 128-bit halves of rows 0-3 and rows 4-7
+    _mm256_storeu_ps(dst + 0 * dst_stride, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(dst + 1 * dst_stride, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(dst + 2 * dst_stride, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(dst + 3 * dst_stride, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(dst + 4 * dst_stride, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(dst + 5 * dst_stride, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(dst + 6 * dst_stride, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(dst + 7 * dst_stride, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+#endif
+
+template <typename T>
+void transpose_tile(const T* src, size_t src_stride, T* dst, size_t dst_stride) {
+#if defined(__AVX__)
+    if constexpr (sizeof(T) == sizeof(float)) {
+        transpose_8x8_avx(reinterpret_cast<const float*>(src), src_stride, reinterpret_cast<float*>(dst),
+                          dst_stride);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < kTile; ++i)
+        for (size_t j = 0; j < kTile; ++j)
+            dst[j * dst_stride + i] = src[i * src_stride + j];
+}
+
+} // namespace transpose_detail
+
+// dst = src^T; dst must be src.cols x src.rows and must not overlap src
+template <typename T>
+void transpose(MatrixView<const T> src, MatrixView<T> dst) {
+    using namespace transpose_detail;
+
+    for (size_t i0 = 0; i0 < src.rows; i0 += kBlock) {
+        const size_t i1 = std::min(src.rows, i0 + kBlock);
+        const size_t i_tiles = i0 + (i1 - i0) / kTile * kTile;
+        for (size_t j0 = 0; j0 < src.cols; j0 += kBlock) {
+            const size_t j1 = std::min(src.cols, j0 + kBlock);
+            const size_t j_tiles = j0 + (j1 - j0) / kTile * kTile;
+
+            for (size_t j = j0; j < j_tiles; j += kTile)
+                for (size_t i = i0; i < i_tiles; i += kTile)
+                    transpose_tile(src[i] + j, src.stride, dst[j] + i, dst.stride);
+
+            for (size_t j = j_tiles; j < j1; ++j)
+                for (size_t i = i0; i < i1; ++i)
+                    dst[j][i] = src[i][j];
+            for (size_t j = j0; j < j_tiles; ++j)
+                for (size_t i = i_tiles; i < i1; ++i)
+                    dst[j][i] = src[i][j];
+        }
+    }
+}
+
+template <typename T>
+void transpose(const Matrix<T>& src, Matrix<T>& dst) {
+    transpose(src.view(), dst.view());
+}
+
+template <typename T>
+Matrix<T> transposed(const Matrix<T>& src) {
+    auto dst = Matrix<T>::uninitialized(src.cols(), src.rows());
+    transpose(src, dst);
+    return dst;
+}
@@ -1,4 +1,5 @@
 #include <benchmark/benchmark.h>
+#include "perf_counters.h"
 #include <atomic>
 #include <mutex>
 #include <vector>
@@ -30,8 +31,10 @@ SpinlockMutex spinlock_mutex;
 // Function to measure real work time
 template <typename MutexType>
 void benchmark_function(benchmark::State& state, MutexType& mutex) {
+    PerfCounters perf;
     int iterations = state.range(0);
 
+    perf.start();
     for (auto _ : state) {
         shared_value = 0; // Reset shared value
         std::vector<std::thread> threads;
@@ -50,6 +53,7 @@ void benchmark_function(benchmark::State& state, MutexType& mutex) {
             t.join();
         }
     }
+    perf.stop(state);
 }
 
 // Benchmark for std::mutex
@@ -72,22 +76,28 @@ BENCHMARK(BM_SpinlockMutex)
     ->Threads(1)->Threads(2)->Threads(4)->Threads(8);
 
 static void BM_Mutex_LockUnlock(benchmark::State& state) {
+    PerfCounters perf;
     std::mutex mtx;
+    perf.start();
     for (auto _ : state) {
         mtx.lock();
         mtx.unlock();
     }
+    perf.stop(state);
 }
 
 static void BM_Mutex_LockUnlock_2(benchmark::State& state) {
     std::mutex mtx;
     std::mutex mtx_1;
+    PerfCounters perf;
+    perf.start();
     for (auto _ : state) {
         mtx.lock();
         mtx.unlock();
         mtx_1.lock();
         mtx_1.unlock();
     }
+    perf.stop(state);
 }
 
 // Register the function as a benchmark
@@ -96,6 +106,8 @@ BENCHMARK(BM_Mutex_LockUnlock_2);
 
 static void BM_Mutex_Contended(benchmark::State& state) {
     std::mutex mtx;
+    PerfCounters perf;
+    perf.start();
     #pragma omp parallel num_threads(state.range(0))
     {
         for (auto _ : state) {
@@ -103,6 +115,7 @@ static void BM_Mutex_Contended(benchmark::State& state) {
             mtx.unlock();
         }
     }
+    perf.stop(state);
 }
 
 BENCHMARK(BM_Mutex_Contended)->Range(1, 8);
@@ -0,0 +1,484 @@
+#pragma once
+
+#include "fuzzy_search.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+// ----------------------------------------------------
+// B+ tree layout: supports Insert / Erase
+// ----------------------------------------------------
+//
+// Keys are kept unique inside the tree with a per-key multiplicity, so the
+// multiset semantics of the static layouts are preserved ({0, 0, 0} stays
+// findable until all three zeros are erased).
+//
+// Inner node keys are separators: every key in children[i] is < keys[i] and
+// every key in children[i + 1] is >= keys[i]. Erasing never breaks that, so
+// separators are not refreshed when the smallest key of a subtree goes away.
+// Leaves are chained left to right, which lets LowerBound step into the next
+// leaf when the answer is not in the one the descent ended in.
+//
+// Nodes hold up to 64 keys (4 cache lines) and, except for the root, never
+// drop below half full, so Insert / Erase / LowerBound are O(log n).
+class BTreeLayout
+{
+public:
+    explicit BTreeLayout(const std::vector<uint32_t>& sorted)
+    {
+        BulkLoad(sorted);
+    }
+
+    BTreeLayout(const BTreeLayout&) = delete;
+    BTreeLayout& operator=(const BTreeLayout&) = delete;
+
+    BTreeLayout(BTreeLayout&& other) noexcept
+        : root_(std::exchange(other.root_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    BTreeLayout& operator=(BTreeLayout&& other) noexcept
+    {
+        std::swap(root_, other.root_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    ~BTreeLayout() { Destroy(root_); }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const
+    {
+        const Node* node = root_;
+        while (!node->leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            node = inner->children[UpperRank(inner->keys, inner->count, key)];
+        }
+
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        const size_t pos = LowerRank(leaf->keys, leaf->count, key);
+        if (pos < leaf->count) {
+            return leaf->keys[pos];
+        }
+        // Everything in this leaf is < key; the answer (if any) is the
+        // smallest key of the next leaf. Only the root leaf can be empty.
+        if (leaf->next != nullptr) {
+            return leaf->next->keys[0];
+        }
+        return std::nullopt;
+    }
+
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            out[i] = LowerBound(keys[i]);
+        }
+    }
+
+    void Insert(uint32_t key)
+    {
+        std::optional<Split> split = Insert(root_, key);
+        if (split) {
+            Inner* root = new Inner;
+            root->count = 1;
+            root->keys[0] = split->separator;
+            root->children[0] = root_;
+            root->children[1] = split->right;
+            root_ = root;
+        }
+        ++size_;
+    }
+
+    // Removes one occurrence of key. Returns false if key is not stored.
+    bool Erase(uint32_t key)
+    {
+        if (!Erase(root_, key)) {
+            return false;
+        }
+        // Collapse a root that was left with a single child
+        if (!root_->leaf && root_->count == 0) {
+            Inner* old = static_cast<Inner*>(root_);
+            root_ = old->children[0];
+            delete old;
+        }
+        --size_;
+        return true;
+    }
+
+    size_t Size() const { return size_; }
+
+    // Walks the whole tree; meant for reporting, not for hot paths.
+    size_t MemoryBytes() const { return NodeBytes(root_); }
+
+private:
+    static constexpr size_t kMaxKeys = 64;
+    static constexpr size_t kMinKeys = kMaxKeys / 2;
+    // Fill factor used by BulkLoad, leaving room for inserts.
+    static constexpr size_t kLoadKeys = kMaxKeys * 3 / 4;
+
+    struct Node {
+        bool leaf;
+        uint32_t count = 0; // number of keys
+    };
+
+    struct Leaf : Node {
+        Leaf() : Node{true} {}
+        alignas(64) uint32_t keys[kMaxKeys];
+        uint32_t multiplicity[kMaxKeys];
+        Leaf* next = nullptr;
+    };
+
+    struct Inner : Node {
+        Inner() : Node{false} {}
+        alignas(64) uint32_t keys[kMaxKeys];
+        Node* children[kMaxKeys + 1];
+    };
+
+    struct Split {
+        uint32_t separator;
+        Node* right;
+    };
+
+    // Number of keys < key / <= key. Plain counting loops over at most 64
+    // keys: no data-dependent branches and they vectorize.
+    static size_t LowerRank(const uint32_t* keys, size_t count, uint32_t key)
+    {
+        size_t rank = 0;
+        for (size_t i = 0; i < count; ++i) {
+            rank += (keys[i] < key);
+        }
+        return rank;
+    }
+
+    static size_t UpperRank(const uint32_t* keys, size_t count, uint32_t key)
+    {
+        size_t rank = 0;
+        for (size_t i = 0; i < count; ++i) {
+            rank += (keys[i] <= key);
+        }
+        return rank;
+    }
+
+    static size_t NodeBytes(const Node* node)
+    {
+        if (node == nullptr) {
+            return 0;
+        }
+        if (node->leaf) {
+            return sizeof(Leaf);
+        }
+        const Inner* inner = static_cast<const Inner*>(node);
+        size_t bytes = sizeof(Inner);
+        for (size_t i = 0; i <= inner->count; ++i) {
+            bytes += NodeBytes(inner->children[i]);
+        }
+        return bytes;
+    }
+
+    static void Destroy(Node* node)
+    {
+        if (node == nullptr) {
+            return;
+        }
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        for (size_t i = 0; i <= inner->count; ++i) {
+            Destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+
+    // ------------------------------------------------
+    // Bulk load
+    // ------------------------------------------------
+
+    // Splits `items` into groups of at most `max_group` (and, when there is
+    // more than one group, at least max_group / 2), aiming for `target` each.
+    static std::vector<size_t> GroupSizes(size_t items, size_t target, size_t max_group)
+    {
+        const size_t groups = std::max({items / target, (items + max_group - 1) / max_group, size_t{1}});
+        std::vector<size_t> sizes(groups, items / groups);
+        for (size_t i = 0; i < items % groups; ++i) {
+            ++sizes[i];
+        }
+        return sizes;
+    }
+
+    void BulkLoad(const std::vector<uint32_t>& sorted)
+    {
+        std::vector<uint32_t> unique;
+        std::vector<uint32_t> multiplicity;
+        for (uint32_t key : sorted) {
+            if (!unique.empty() && unique.back() == key) {
+                ++multiplicity.back();
+            } else {
+                unique.push_back(key);
+                multiplicity.push_back(1);
+            }
+        }
+        size_ = sorted.size();
+
+        // Level 0: leaves, each remembered with its smallest key
+        std::vector<std::pair<uint32_t, Node*>> level;
+        Leaf* prev = nullptr;
+        size_t pos = 0;
+        for (size_t group : GroupSizes(unique.size(), kLoadKeys, kMaxKeys)) {
+            Leaf* leaf = new Leaf;
+            leaf->count = static_cast<uint32_t>(group);
+            std::copy_n(unique.begin() + pos, group, leaf->keys);
+            std::copy_n(multiplicity.begin() + pos, group, leaf->multiplicity);
+            if (prev != nullptr) {
+                prev->next = leaf;
+            }
+            prev = leaf;
+            level.emplace_back(group == 0 ? 0 : unique[pos], leaf);
+            pos += group;
+        }
+
+        // Upper levels until a single root is left
+        while (level.size() > 1) {
+            std::vector<std::pair<uint32_t, Node*>> parents;
+            size_t child = 0;
+            for (size_t group : GroupSizes(level.size(), kLoadKeys + 1, kMaxKeys + 1)) {
+                Inner* inner = new Inner;
+                inner->count = static_cast<uint32_t>(group - 1);
+                for (size_t i = 0; i < group; ++i) {
+                    inner->children[i] = level[child + i].second;
+                    if (i > 0) {
+                        inner->keys[i - 1] = level[child + i].first;
+                    }
+                }
+                parents.emplace_back(level[child].first, inner);
+                child += group;
+            }
+            level = std::move(parents);
+        }
+        root_ = level[0].second;
+    }
+
+    // ------------------------------------------------
+    // Insert
+    // ------------------------------------------------
+
+    // Inserts into the subtree; if the node had to split, returns the new
+    // right sibling and the separator the parent needs.
+    static std::optional<Split> Insert(Node* node, uint32_t key)
+    {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t pos = LowerRank(leaf->keys, leaf->count, key);
+            if (pos < leaf->count && leaf->keys[pos] == key) {
+                ++leaf->multiplicity[pos];
+                return std::nullopt;
+            }
+
+            std::optional<Split> split;
+            if (leaf->count == kMaxKeys) {
+                Leaf* right = new Leaf;
+                right->count = kMaxKeys - kMinKeys;
+                std::copy_n(leaf->keys + kMinKeys, right->count, right->keys);
+                std::copy_n(leaf->multiplicity + kMinKeys, right->count, right->multiplicity);
+                right->next = leaf->next;
+                leaf->next = right;
+                leaf->count = kMinKeys;
+                split = Split{right->keys[0], right};
+                if (pos > kMinKeys) {
+                    leaf = right;
+                    pos -= kMinKeys;
+                }
+            }
+
+            std::copy_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::copy_backward(leaf->multiplicity + pos, leaf->multiplicity + leaf->count,
+                               leaf->multiplicity + leaf->count + 1);
+            leaf->keys[pos] = key;
+            leaf->multiplicity[pos] = 1;
+            ++leaf->count;
+            return split;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        size_t pos = UpperRank(inner->keys, inner->count, key);
+        std::optional<Split> child_split = Insert(inner->children[pos], key);
+        if (!child_split) {
+            return std::nullopt;
+        }
+
+        // The new child goes right after children[pos] with its separator at
+        // keys[pos]. Make room first if this node is full.
+        std::optional<Split> split;
+        if (inner->count == kMaxKeys) {
+            // Keys [0, kMinKeys) stay, keys[kMinKeys] moves up, the rest
+            // (and their children) move to the new right node.
+            Inner* right = new Inner;
+            right->count = kMaxKeys - kMinKeys - 1;
+            std::copy_n(inner->keys + kMinKeys + 1, right->count, right->keys);
+            std::copy_n(inner->children + kMinKeys + 1, right->count + 1, right->children);
+            inner->count = kMinKeys;
+            split = Split{inner->keys[kMinKeys], right};
+            if (pos > kMinKeys) {
+                inner = right;
+                pos -= kMinKeys + 1;
+            }
+        }
+
+        std::copy_backward(inner->keys + pos, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::copy_backward(inner->children + pos + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[pos] = child_split->separator;
+        inner->children[pos + 1] = child_split->right;
+        ++inner->count;
+        return split;
+    }
+
+    // ------------------------------------------------
+    // Erase
+    // ------------------------------------------------
+
+    static bool Erase(Node* node, uint32_t key)
+    {
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            const size_t pos = LowerRank(leaf->keys, leaf->count, key);
+            if (pos == leaf->count || leaf->keys[pos] != key) {
+                return false;
+            }
+            if (--leaf->multiplicity[pos] == 0) {
+                std::copy(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+                std::copy(leaf->multiplicity + pos + 1, leaf->multiplicity + leaf->count, leaf->multiplicity + pos);
+                --leaf->count;
+            }
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        const size_t pos = UpperRank(inner->keys, inner->count, key);
+        if (!Erase(inner->children[pos], key)) {
+            return false;
+        }
+        if (inner->children[pos]->count < kMinKeys) {
+            Rebalance(inner, pos);
+        }
+        return true;
+    }
+
+    // children[pos] just dropped below kMinKeys: borrow one key from a
+    // sibling that can spare it, otherwise merge with a sibling.
+    static void Rebalance(Inner* parent, size_t pos)
+    {
+        Node* left = pos > 0 ? parent->children[pos - 1] : nullptr;
+        Node* right = pos < parent->count ? parent->children[pos + 1] : nullptr;
+
+        if (left != nullptr && left->count > kMinKeys) {
+            BorrowFromLeft(parent, pos);
+        } else if (right != nullptr && right->count > kMinKeys) {
+            BorrowFromRight(parent, pos);
+        } else if (left != nullptr) {
+            Merge(parent, pos - 1);
+        } else if (right != nullptr) {
+            Merge(parent, pos);
+        }
+    }
+
+    static void BorrowFromLeft(Inner* parent, size_t pos)
+    {
+        Node* node = parent->children[pos];
+        Node* sibling = parent->children[pos - 1];
+
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            Leaf* left = static_cast<Leaf*>(sibling);
+            std::copy_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::copy_backward(leaf->multiplicity, leaf->multiplicity + leaf->count,
+                               leaf->multiplicity + leaf->count + 1);
+            leaf->keys[0] = left->keys[left->count - 1];
+            leaf->multiplicity[0] = left->multiplicity[left->count - 1];
+            ++leaf->count;
+            --left->count;
+            parent->keys[pos - 1] = leaf->keys[0];
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        Inner* left = static_cast<Inner*>(sibling);
+        std::copy_backward(inner->keys, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::copy_backward(inner->children, inner->children + inner->count + 1, inner->children + inner->count + 2);
+        inner->keys[0] = parent->keys[pos - 1];
+        inner->children[0] = left->children[left->count];
+        ++inner->count;
+        parent->keys[pos - 1] = left->keys[left->count - 1];
+        --left->count;
+    }
+
+    static void BorrowFromRight(Inner* parent, size_t pos)
+    {
+        Node* node = parent->children[pos];
+        Node* sibling = parent->children[pos + 1];
+
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            Leaf* right = static_cast<Leaf*>(sibling);
+            leaf->keys[leaf->count] = right->keys[0];
+            leaf->multiplicity[leaf->count] = right->multiplicity[0];
+            ++leaf->count;
+            std::copy(right->keys + 1, right->keys + right->count, right->keys);
+            std::copy(right->multiplicity + 1, right->multiplicity + right->count, right->multiplicity);
+            --right->count;
+            parent->keys[pos] = right->keys[0];
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        Inner* right = static_cast<Inner*>(sibling);
+        inner->keys[inner->count] = parent->keys[pos];
+        inner->children[inner->count + 1] = right->children[0];
+        ++inner->count;
+        parent->keys[pos] = right->keys[0];
+        std::copy(right->keys + 1, right->keys + right->count, right->keys);
+        std::copy(right->children + 1, right->children + right->count + 1, right->children);
+        --right->count;
+    }
+
+    // Folds children[pos + 1] into children[pos] and drops separator pos.
+    static void Merge(Inner* parent, size_t pos)
+    {
+        Node* node = parent->children[pos];
+        Node* sibling = parent->children[pos + 1];
+
+        if (node->leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            Leaf* right = static_cast<Leaf*>(sibling);
+            std::copy_n(right->keys, right->count, leaf->keys + leaf->count);
+            std::copy_n(right->multiplicity, right->count, leaf->multiplicity + leaf->count);
+            leaf->count += right->count;
+            leaf->next = right->next;
+            delete right;
+        } else {
+            Inner* inner = static_cast<Inner*>(node);
+            Inner* right = static_cast<Inner*>(sibling);
+            inner->keys[inner->count] = parent->keys[pos];
+            std::copy_n(right->keys, right->count, inner->keys + inner->count + 1);
+            std::copy_n(right->children, right->count + 1, inner->children + inner->count + 1);
+            inner->count += right->count + 1;
+            delete right;
+        }
+
+        std::copy(parent->keys + pos + 1, parent->keys + parent->count, parent->keys + pos);
+        std::copy(parent->children + pos + 2, parent->children + parent->count + 1, parent->children + pos + 1);
+        --parent->count;
+    }
+
+    Node* root_ = nullptr;
+    size_t size_ = 0;
+};
+
+// FuzzySearch with Insert / Erase
+using DynamicFuzzySearch = BasicFuzzySearch<BTreeLayout>;
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "fuzzy_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Datasets and query streams shared by the benchmarks
+// -----------------------------------------------------------------------------
+
+inline std::vector<uint32_t> RandomKeys(size_t n, uint32_t seed)
+{
+    std::mt19937 rng{seed};
+    std::vector<uint32_t> keys(n);
+    for (auto& k : keys) {
+        k = rng();
+    }
+    return keys;
+}
+
+enum class KeyDistribution : int {
+    Uniform = 0,
+    Lognormal = 1, // dense near zero, long sparse tail
+    Clustered = 2, // 64 narrow normal clusters at random centres
+};
+
+inline std::vector<uint32_t> DistributedKeys(size_t n, KeyDistribution dist, uint32_t seed)
+{
+    if (dist == KeyDistribution::Uniform) {
+        return RandomKeys(n, seed);
+    }
+
+    std::mt19937 rng{seed};
+    auto clamp = [](double v) { return static_cast<uint32_t>(std::clamp(v, 0.0, static_cast<double>(MAX_VAL))); };
+    std::vector<uint32_t> keys(n);
+    if (dist == KeyDistribution::Lognormal) {
+        std::lognormal_distribution<double> lognormal(0.0, 2.0);
+        for (auto& k : keys) {
+            k = clamp(lognormal(rng) * 1e5);
+        }
+    } else {
+        // Centres come from a fixed stream so that keys and queries drawn
+        // with different seeds share the same clusters
+        std::mt19937 centre_rng{1};
+        std::vector<double> centres(64);
+        for (auto& c : centres) {
+            c = static_cast<double>(centre_rng());
+        }
+        std::normal_distribution<double> spread(0.0, 1 << 20);
+        for (auto& k : keys) {
+            k = clamp(centres[rng() % centres.size()] + spread(rng));
+        }
+    }
+    return keys;
+}
+
+// Ranks 0 .. n-1 with P(r) ~ 1 / (r + 1)^s, sampled by inverting the CDF of
+// the continuous approximation. s == 0 is uniform; s around 1 is the usual
+// "few hot keys" web workload. O(1) memory, so it works for any n.
+class ZipfRanks
+{
+public:
+    ZipfRanks(size_t n, double s)
+        : n_(static_cast<double>(n))
+        , s_(s)
+    {
+    }
+
+    template <typename Rng>
+    size_t operator()(Rng& rng)
+    {
+        const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double r;
+        if (s_ == 0.0) {
+            r = u * n_;
+        } else if (std::abs(s_ - 1.0) < 1e-9) {
+            r = std::pow(n_ + 1.0, u) - 1.0;
+        } else {
+            const double a = 1.0 - s_;
+            r = std::pow(u * (std::pow(n_ + 1.0, a) - 1.0) + 1.0, 1.0 / a) - 1.0;
+        }
+        return std::min(static_cast<size_t>(r), static_cast<size_t>(n_) - 1);
+    }
+
+private:
+    double n_;
+    double s_;
+};
+
+// Query stream for Find over `sorted` keys:
+//
+//   * hits are stored keys (Find(k) always returns something for a stored
+//     k), picked by Zipf rank; ranks are scattered over the key array with
+//     a multiplicative hash so the hot keys are not neighbours;
+//   * misses are log-uniform draws over the 32-bit range that Find rejects.
+//     FuzzySearch accepts anything in [x/2, 2x], so on dense data the misses
+//     are the small queries; log-uniform draws keep enough of them.
+//
+// hit_percent is a target; if the data leaves too few misses the stream
+// gets hits instead, so report the measured ratio, not the requested one.
+inline std::vector<uint32_t> MakeQueries(const std::vector<uint32_t>& sorted, size_t count, int hit_percent,
+                                        double zipf_s, uint32_t seed)
+{
+    std::mt19937_64 rng{seed};
+    const BasicFuzzySearch<SortedViewLayout> reference(SortedViewLayout(sorted.data(), sorted.size()));
+    ZipfRanks ranks(sorted.size(), zipf_s);
+
+    auto hit = [&]() {
+        const uint64_t scattered = static_cast<uint64_t>(ranks(rng)) * 0x9E3779B97F4A7C15ull;
+        return sorted[scattered % sorted.size()];
+    };
+    auto miss = [&](uint32_t& out) {
+        for (int attempt = 0; attempt < 64; ++attempt) {
+            const double log2 = std::uniform_real_distribution<double>(0.0, 32.0)(rng);
+            const uint32_t x = static_cast<uint32_t>(std::min(std::exp2(log2), static_cast<double>(MAX_VAL)));
+            if (!reference.Find(x)) {
+                out = x;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<uint32_t> queries(count);
+    std::uniform_int_distribution<int> percent(0, 99);
+    for (auto& q : queries) {
+        if (percent(rng) >= hit_percent && miss(q)) {
+            continue;
+        }
+        q = hit();
+    }
+    return queries;
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "aligned_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------
+// Compressed layout: delta + bit-packed blocks
+// ----------------------------------------------------
+//
+// Sorted keys are cut into blocks of 128. The skip index keeps, per block,
+// the first key (uncompressed), the bit width and the offset of its packed
+// data. Lookups binary-search the heads and then decode a single block.
+//
+// Inside a block key i sits in lane i % 8, row i / 8, and what gets packed is
+// its distance to the key one row up (key[i] - key[i - 8], with the block head
+// standing in above row 0). All 128 distances are stored with the block's
+// maximum bit width (frame of reference). Lane j's 16 values form one bit
+// stream, and word w of all 8 streams is stored together as one 32-byte row,
+// so the decoder unpacks a whole row with a couple of 8-wide shifts and turns
+// distances back into keys with a single vector add per row: no horizontal
+// prefix sums.
+//
+// The last block is padded with copies of the last key.
+class CompressedLayout
+{
+public:
+    static constexpr size_t kBlock = 128;
+
+    explicit CompressedLayout(const std::vector<uint32_t>& sorted)
+        : size_(sorted.size())
+    {
+        const size_t blocks = (sorted.size() + kBlock - 1) / kBlock;
+        heads_.reserve(blocks);
+        offsets_.reserve(blocks);
+        widths_.reserve(blocks);
+
+        uint32_t values[kBlock];
+        for (size_t first = 0; first < sorted.size(); first += kBlock) {
+            const size_t count = std::min(kBlock, sorted.size() - first);
+            std::copy_n(sorted.begin() + first, count, values);
+            std::fill(values + count, values + kBlock, values[count - 1]);
+            Encode(values);
+        }
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const
+    {
+        // Blocks [0, b) start at or below key; the answer is in block b - 1
+        // or, if that block has nothing >= key, it is the head of block b.
+        const size_t b = std::upper_bound(heads_.begin(), heads_.end(), key) - heads_.begin();
+        if (b == 0) {
+            return heads_.empty() ? std::nullopt : std::optional<uint32_t>(heads_[0]);
+        }
+        return FromBlock(b - 1, key);
+    }
+
+    // Two passes over the block of queries: first find every block and
+    // prefetch its packed data, then decode.
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        for (size_t first = 0; first < keys.size(); first += kLanes) {
+            const size_t lanes = std::min(kLanes, keys.size() - first);
+
+            size_t block[kLanes];
+            for (size_t j = 0; j < lanes; ++j) {
+                block[j] = std::upper_bound(heads_.begin(), heads_.end(), keys[first + j]) - heads_.begin();
+                if (block[j] != 0) {
+                    __builtin_prefetch(packed_.data() + offsets_[block[j] - 1]);
+                }
+            }
+
+            for (size_t j = 0; j < lanes; ++j) {
+                if (block[j] == 0) {
+                    out[first + j] = heads_.empty() ? std::nullopt : std::optional<uint32_t>(heads_[0]);
+                } else {
+                    out[first + j] = FromBlock(block[j] - 1, keys[first + j]);
+                }
+            }
+        }
+    }
+
+    // Decodes block b (kBlock keys, padded) into out.
+    void DecodeBlock(size_t b, uint32_t* out) const
+    {
+        Decode(heads_[b], widths_[b], packed_.data() + offsets_[b], out);
+    }
+
+    size_t Size() const { return size_; }
+
+    size_t MemoryBytes() const
+    {
+        return heads_.size() * sizeof(uint32_t) + offsets_.size() * sizeof(uint64_t)
+             + widths_.size() * sizeof(uint8_t) + packed_.size() * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr size_t kLanes = 32;
+    static constexpr size_t kWidth = 8;                // SIMD lanes
+    static constexpr size_t kRows = kBlock / kWidth;   // values per lane
+
+    // Packed 32-bit words per lane for a given bit width
+    static size_t WordsPerLane(unsigned bits) { return (kRows * bits + 31) / 32; }
+
+    std::optional<uint32_t> FromBlock(size_t b, uint32_t key) const
+    {
+        alignas(32) uint32_t values[kBlock];
+        DecodeBlock(b, values);
+
+        size_t rank = 0;
+        for (size_t i = 0; i < kBlock; ++i) {
+            rank += (values[i] < key);
+        }
+
+        // Padding repeats the last key, so it never hides a real answer
+        const size_t valid = std::min(kBlock, size_ - b * kBlock);
+        if (rank < valid) {
+            return values[rank];
+        }
+        if (b + 1 < heads_.size()) {
+            return heads_[b + 1];
+        }
+        return std::nullopt;
+    }
+
+    void Encode(const uint32_t* values)
+    {
+        const uint32_t head = values[0];
+        uint32_t deltas[kBlock];
+        uint32_t max_delta = 0;
+        for (size_t i = 0; i < kBlock; ++i) {
+            deltas[i] = values[i] - (i < kWidth ? head : values[i - kWidth]);
+            max_delta = std::max(max_delta, deltas[i]);
+        }
+        const unsigned bits = static_cast<unsigned>(std::bit_width(max_delta));
+
+        heads_.push_back(head);
+        offsets_.push_back(packed_.size());
+        widths_.push_back(static_cast<uint8_t>(bits));
+
+        const size_t words = WordsPerLane(bits);
+        const size_t base = packed_.size();
+        packed_.resize(base + words * kWidth, 0);
+        for (size_t lane = 0; lane < kWidth && bits != 0; ++lane) {
+            size_t bit = 0;
+            for (size_t row = 0; row < kRows; ++row) {
+                const uint64_t value = deltas[row * kWidth + lane];
+                const size_t word = bit / 32;
+                const unsigned shift = bit % 32;
+                packed_[base + word * kWidth + lane] |= static_cast<uint32_t>(value << shift);
+                if (shift + bits > 32) {
+                    packed_[base + (word + 1) * kWidth + lane] |= static_cast<uint32_t>(value >> (32 - shift));
+                }
+                bit += bits;
+            }
+        }
+    }
+
+    static void Decode(uint32_t head, unsigned bits, const uint32_t* in, uint32_t* out)
+    {
+        if (bits == 0) {
+            // All keys equal the head; nothing was packed
+            std::fill(out, out + kBlock, head);
+            return;
+        }
+
+#if defined(__AVX2__)
+        const __m256i mask = _mm256_set1_epi32(bits == 32 ? -1 : static_cast<int>((1u << bits) - 1));
+        const __m256i* rows = reinterpret_cast<const __m256i*>(in);
+        __m256i prev = _mm256_set1_epi32(static_cast<int>(head));
+        __m256i cur = _mm256_load_si256(rows);
+        unsigned used = 0;
+
+        for (size_t row = 0; row < kRows; ++row) {
+            __m256i v = _mm256_srl_epi32(cur, _mm_cvtsi32_si128(static_cast<int>(used)));
+            used += bits;
+            if (used > 32) {
+                // The value straddles two words
+                cur = _mm256_load_si256(++rows);
+                used -= 32;
+                v = _mm256_or_si256(v, _mm256_sll_epi32(cur, _mm_cvtsi32_si128(static_cast<int>(bits - used))));
+            } else if (used == 32 && row + 1 < kRows) {
+                cur = _mm256_load_si256(++rows);
+                used = 0;
+            }
+            prev = _mm256_add_epi32(prev, _mm256_and_si256(v, mask));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + row * kWidth), prev);
+        }
+#else
+        const uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+        for (size_t lane = 0; lane < kWidth; ++lane) {
+            uint32_t prev = head;
+            size_t bit = 0;
+            for (size_t row = 0; row < kRows; ++row) {
+                const size_t word = bit / 32;
+                const unsigned shift = bit % 32;
+                uint64_t value = in[word * kWidth + lane] >> shift;
+                if (shift + bits > 32) {
+                    value |= static_cast<uint64_t>(in[(word + 1) * kWidth + lane]) << (32 - shift);
+                }
+                prev += static_cast<uint32_t>(value) & mask;
+                out[row * kWidth + lane] = prev;
+                bit += bits;
+            }
+        }
+#endif
+    }
+
+    size_t size_;
+    std::vector<uint32_t> heads_;
+    std::vector<uint64_t> offsets_; // into packed_, in words
+    std::vector<uint8_t> widths_;
+    // Every block starts on a 32-byte boundary: block sizes are multiples
+    // of 8 words.
+    std::vector<uint32_t, AlignedAllocator<uint32_t>> packed_;
+};
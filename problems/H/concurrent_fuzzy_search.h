@@ -0,0 +1,183 @@
+#pragma once
+
+#include "fuzzy_search.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ----------------------------------------------------
+// Concurrent FuzzySearch: immutable snapshots + epochs
+// ----------------------------------------------------
+//
+// The current snapshot sits behind an atomic pointer. Writers build a new
+// snapshot off to the side and swap it in with Publish; readers never lock
+// and never wait for a writer.
+//
+// Reclamation is epoch based. Every reader owns a cache-line sized slot. For
+// the duration of a lookup the slot holds the global epoch the reader saw on
+// entry, and 0 otherwise. Publish bumps the epoch after swapping the pointer
+// and tags the old snapshot with the new epoch value; the old snapshot is
+// freed once every slot is either 0 or at least that tag, because a reader
+// that announced the new epoch is guaranteed to have loaded the new pointer.
+template <typename Search = FuzzySearch>
+class ConcurrentFuzzySearch
+{
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<bool> in_use{false};
+    };
+
+public:
+    static constexpr size_t kMaxReaders = 256;
+
+    explicit ConcurrentFuzzySearch(std::unique_ptr<const Search> initial)
+        : current_(initial.release())
+    {
+    }
+
+    ConcurrentFuzzySearch(const ConcurrentFuzzySearch&) = delete;
+    ConcurrentFuzzySearch& operator=(const ConcurrentFuzzySearch&) = delete;
+
+    // All readers must be gone by now.
+    ~ConcurrentFuzzySearch()
+    {
+        delete current_.load();
+        for (auto& retired : retired_) {
+            delete retired.second;
+        }
+    }
+
+    // A registered reader thread. Each thread that queries the index keeps
+    // its own Reader; a Reader must not be shared between threads.
+    class Reader
+    {
+    public:
+        Reader(Reader&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr))
+            , slot_(std::exchange(other.slot_, nullptr))
+        {
+        }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        ~Reader()
+        {
+            if (slot_ != nullptr) {
+                slot_->in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        std::optional<uint32_t> Find(uint32_t x) const
+        {
+            const Search* snapshot = Enter();
+            auto result = snapshot->Find(x);
+            Leave();
+            return result;
+        }
+
+        // One epoch announcement for the whole block of queries.
+        void FindBatch(std::span<const uint32_t> queries, std::span<std::optional<uint32_t>> out) const
+        {
+            const Search* snapshot = Enter();
+            snapshot->FindBatch(queries, out);
+            Leave();
+        }
+
+    private:
+        friend class ConcurrentFuzzySearch;
+
+        Reader(const ConcurrentFuzzySearch* owner, Slot* slot)
+            : owner_(owner)
+            , slot_(slot)
+        {
+        }
+
+        const Search* Enter() const
+        {
+            // Both operations are seq_cst: the announcement must be globally
+            // visible before we read the pointer (see the class comment).
+            slot_->epoch.store(owner_->epoch_.load());
+            return owner_->current_.load();
+        }
+
+        void Leave() const { slot_->epoch.store(0, std::memory_order_release); }
+
+        const ConcurrentFuzzySearch* owner_;
+        Slot* slot_;
+    };
+
+    // Claims a free reader slot. Lock-free; throws if all kMaxReaders slots
+    // are taken.
+    Reader RegisterReader()
+    {
+        for (auto& slot : slots_) {
+            bool expected = false;
+            if (!slot.in_use.load(std::memory_order_relaxed)
+                && slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return Reader(this, &slot);
+            }
+        }
+        throw std::runtime_error("ConcurrentFuzzySearch: too many readers");
+    }
+
+    // Swaps in a new snapshot and frees every old one no reader can still see.
+    // Writers are serialized among themselves; readers are never blocked.
+    void Publish(std::unique_ptr<const Search> next)
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        const Search* old = current_.exchange(next.release());
+        const uint64_t tag = epoch_.fetch_add(1) + 1;
+        retired_.emplace_back(tag, old);
+        ReclaimLocked();
+    }
+
+    // Frees retired snapshots that are no longer reachable by any reader.
+    // Returns how many are still waiting for readers to move on.
+    size_t Reclaim()
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        ReclaimLocked();
+        return retired_.size();
+    }
+
+private:
+    void ReclaimLocked()
+    {
+        // Oldest epoch any reader may still be working in
+        uint64_t min_active = UINT64_MAX;
+        for (auto& slot : slots_) {
+            const uint64_t e = slot.epoch.load();
+            if (e != 0 && e < min_active) {
+                min_active = e;
+            }
+        }
+
+        size_t kept = 0;
+        for (auto& retired : retired_) {
+            if (retired.first <= min_active) {
+                delete retired.second;
+            } else {
+                retired_[kept++] = retired;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    std::atomic<const Search*> current_;
+    alignas(64) std::atomic<uint64_t> epoch_{1};
+    std::array<Slot, kMaxReaders> slots_;
+
+    std::mutex writer_mutex_;
+    std::vector<std::pair<uint64_t, const Search*>> retired_;
+};
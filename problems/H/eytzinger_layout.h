@@ -0,0 +1,143 @@
+#pragma once
+
+#include "aligned_allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// ----------------------------------------------------
+// Eytzinger (BFS / heap order) layout
+// ----------------------------------------------------
+//
+// Keys are stored 1-indexed in the order of a breadth-first traversal of the
+// implicit binary search tree: the children of node k are 2k and 2k + 1.
+// The top levels of the tree share a handful of cache lines, and the 16
+// great-great-grandchildren of node k (indices 16k .. 16k + 15) occupy exactly
+// one cache line, so we prefetch that line four levels ahead of the search.
+//
+// As with the sorted layout, the search runs over a non-owning view.
+class EytzingerViewLayout
+{
+public:
+    // `tree` holds size + 1 entries; tree[0] is unused.
+    EytzingerViewLayout(const uint32_t* tree, size_t size)
+        : tree_(tree)
+        , size_(size)
+    {
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const
+    {
+        const size_t n = size_;
+        size_t k = 1;
+        while (k <= n) {
+            Prefetch(k * kBlock);
+            k = 2 * k + (tree_[k] < key);
+        }
+        // The path went right every time it saw an element < key and left
+        // otherwise. The answer is the last node where we went left: strip
+        // the trailing "right" turns plus that one "left" turn.
+        k >>= __builtin_ffsll(~k);
+        if (k == 0) {
+            return std::nullopt;
+        }
+        return tree_[k];
+    }
+
+    // Lockstep version of LowerBound. The top floor(log2(n + 1)) levels are
+    // complete, so every search takes exactly that many steps plus at most
+    // one more into the partially filled bottom level.
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        const size_t n = size_;
+        const size_t full_levels = std::bit_width(n + 1) - 1;
+
+        for (size_t first = 0; first < keys.size(); first += kLanes) {
+            const size_t lanes = std::min(kLanes, keys.size() - first);
+            const uint32_t* key = keys.data() + first;
+
+            size_t k[kLanes];
+            std::fill(k, k + lanes, size_t{1});
+
+            for (size_t level = 0; level < full_levels; ++level) {
+                for (size_t j = 0; j < lanes; ++j) {
+                    Prefetch(k[j] * kBlock);
+                    k[j] = 2 * k[j] + (tree_[k[j]] < key[j]);
+                }
+            }
+
+            for (size_t j = 0; j < lanes; ++j) {
+                size_t kj = k[j];
+                if (kj <= n) {
+                    kj = 2 * kj + (tree_[kj] < key[j]);
+                }
+                kj >>= __builtin_ffsll(~kj);
+                out[first + j] = (kj != 0) ? std::optional<uint32_t>(tree_[kj]) : std::nullopt;
+            }
+        }
+    }
+
+    // The whole array including the unused slot 0.
+    std::span<const uint32_t> Tree() const { return {tree_, size_ + 1}; }
+
+    size_t Size() const { return size_; }
+
+private:
+    // Number of keys per cache line.
+    static constexpr size_t kBlock = 64 / sizeof(uint32_t);
+    // Searches advanced together by LowerBoundBatch.
+    static constexpr size_t kLanes = 32;
+
+    void Prefetch(size_t index) const
+    {
+        // The prefetched index may run past the end of the array near the
+        // leaves; prefetches never fault, so we only keep the pointer math
+        // out of the language's hands.
+        auto addr = reinterpret_cast<uintptr_t>(tree_) + index * sizeof(uint32_t);
+        __builtin_prefetch(reinterpret_cast<const void*>(addr));
+    }
+
+    const uint32_t* tree_;
+    size_t size_;
+};
+
+class EytzingerLayout
+{
+public:
+    explicit EytzingerLayout(const std::vector<uint32_t>& sorted)
+        : tree_(sorted.size() + 1)
+    {
+        size_t i = 0;
+        Build(sorted, i, 1);
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const { return View().LowerBound(key); }
+
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        View().LowerBoundBatch(keys, out);
+    }
+
+    EytzingerViewLayout View() const { return {tree_.data(), Size()}; }
+
+    size_t Size() const { return tree_.size() - 1; }
+
+    size_t MemoryBytes() const { return tree_.size() * sizeof(uint32_t); }
+
+private:
+    void Build(const std::vector<uint32_t>& sorted, size_t& i, size_t k)
+    {
+        if (k <= Size()) {
+            Build(sorted, i, 2 * k);
+            tree_[k] = sorted[i++];
+            Build(sorted, i, 2 * k + 1);
+        }
+    }
+
+    std::vector<uint32_t, AlignedAllocator<uint32_t>> tree_;
+};
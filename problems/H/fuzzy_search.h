@@ -0,0 +1,308 @@
+#pragma once
+
+#include "radix_sort.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+static constexpr uint32_t HALF_MAX = std::numeric_limits<uint32_t>::max() / 2;
+static constexpr uint32_t MAX_VAL  = std::numeric_limits<uint32_t>::max();
+
+// ----------------------------------------------------
+// Query range [ceil(x / 2), min(2x, MAX_VAL)]
+// ----------------------------------------------------
+inline uint32_t FuzzyLower(uint32_t x)
+{
+    return (x >> 1) + (x & 1); // ceiling of x / 2 for any x, avoiding potential overflow from doing x + 1
+}
+
+inline uint32_t FuzzyUpper(uint32_t x)
+{
+    return (x > HALF_MAX) ? MAX_VAL : (x << 1); // probably this can be done without branches
+}
+
+// Bounds for a block of queries, 8 at a time. Here the clamp is branchless:
+// x > HALF_MAX exactly when the top bit of x is set, and an arithmetic shift
+// right by 31 turns that bit into an all-ones mask.
+inline void FuzzyBounds(const uint32_t* x, size_t n, uint32_t* lower, uint32_t* upper)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i one = _mm256_set1_epi32(1);
+    for (; i + 8 <= n; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        const __m256i lo = _mm256_add_epi32(_mm256_srli_epi32(v, 1), _mm256_and_si256(v, one));
+        const __m256i hi = _mm256_or_si256(_mm256_slli_epi32(v, 1), _mm256_srai_epi32(v, 31));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lower + i), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(upper + i), hi);
+    }
+#endif
+    for (; i < n; ++i) {
+        lower[i] = FuzzyLower(x[i]);
+        upper[i] = FuzzyUpper(x[i]);
+    }
+}
+
+// ----------------------------------------------------
+// Default layout: plain sorted array + std::lower_bound
+// ----------------------------------------------------
+//
+// A layout owns the keys and answers a single question: what is the
+// smallest stored key that is >= `key`? Every layout receives the keys
+// already sorted, and also answers the question for a block of keys at once
+// (LowerBoundBatch), walking all of them down the structure in lockstep so
+// their cache misses overlap.
+//
+// The search itself lives in a non-owning view so the same code can run over
+// keys stored elsewhere, e.g. a memory-mapped index file.
+class SortedViewLayout
+{
+public:
+    SortedViewLayout(const uint32_t* data, size_t size)
+        : data_(data)
+        , size_(size)
+    {
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const
+    {
+        const uint32_t* end = data_ + size_;
+        const uint32_t* it = std::lower_bound(data_, end, key);
+        if (it != end) {
+            return *it;
+        }
+        return std::nullopt;
+    }
+
+    // Branchless binary search: every search in the block takes exactly the
+    // same number of steps, so we advance them together one level at a time
+    // and prefetch both possible probes of the next level.
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        const size_t n = size_;
+        if (n == 0) {
+            std::fill(out.begin(), out.begin() + keys.size(), std::nullopt);
+            return;
+        }
+
+        for (size_t first = 0; first < keys.size(); first += kLanes) {
+            const size_t lanes = std::min(kLanes, keys.size() - first);
+            const uint32_t* key = keys.data() + first;
+
+            const uint32_t* base[kLanes];
+            std::fill(base, base + lanes, data_);
+
+            for (size_t len = n; len > 1; ) {
+                const size_t half = len / 2;
+                len -= half;
+                const size_t probe = (len > 1) ? len / 2 - 1 : 0;
+                for (size_t j = 0; j < lanes; ++j) {
+                    base[j] += (base[j][half - 1] < key[j]) * half;
+                    __builtin_prefetch(base[j] + probe);
+                    __builtin_prefetch(base[j] + half + probe);
+                }
+            }
+
+            for (size_t j = 0; j < lanes; ++j) {
+                const uint32_t* it = base[j] + (*base[j] < key[j]);
+                out[first + j] = (it != data_ + n) ? std::optional<uint32_t>(*it) : std::nullopt;
+            }
+        }
+    }
+
+    std::span<const uint32_t> Data() const { return {data_, size_}; }
+
+    size_t Size() const { return size_; }
+
+private:
+    static constexpr size_t kLanes = 32;
+
+    const uint32_t* data_;
+    size_t size_;
+};
+
+class SortedLayout
+{
+public:
+    explicit SortedLayout(std::vector<uint32_t> sorted)
+        : data_(std::move(sorted))
+    {
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const { return View().LowerBound(key); }
+
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        View().LowerBoundBatch(keys, out);
+    }
+
+    SortedViewLayout View() const { return {data_.data(), data_.size()}; }
+
+    std::span<const uint32_t> Data() const { return data_; }
+
+    size_t Size() const { return data_.size(); }
+
+    size_t MemoryBytes() const { return data_.size() * sizeof(uint32_t); }
+
+private:
+    std::vector<uint32_t> data_;
+};
+
+// ----------------------------------------------------
+// FuzzySearch: for a query x, return some stored element
+// from [ceil(x / 2), 2x]. We always return the smallest one.
+// ----------------------------------------------------
+template <typename Layout>
+class BasicFuzzySearch
+{
+public:
+    explicit BasicFuzzySearch(const std::vector<uint32_t>& input)
+        : layout_(SortedCopy(input))
+    {
+    }
+
+    // Takes over `input` and sorts it in place instead of copying it. With
+    // threads == 1 this is std::sort and allocates nothing; with more it is
+    // a parallel radix sort that needs one scratch buffer of input.size().
+    explicit BasicFuzzySearch(std::vector<uint32_t>&& input, unsigned threads = 1)
+        : layout_(SortedInPlace(std::move(input), threads))
+    {
+    }
+
+    // Wraps a layout that is already built (or a view over one).
+    explicit BasicFuzzySearch(Layout layout)
+        : layout_(std::move(layout))
+    {
+    }
+
+    std::optional<uint32_t> Find(uint32_t x) const
+    {
+        const uint32_t lower = FuzzyLower(x);
+        const uint32_t upper = FuzzyUpper(x);
+
+        auto found = layout_.LowerBound(lower);
+        if (found && *found <= upper) {
+            return found;
+        }
+        return std::nullopt;
+    }
+
+    // Same as calling Find for every query, but the bounds are computed with
+    // SIMD and the searches of a whole block run in lockstep so that their
+    // memory accesses are in flight at the same time.
+    void FindBatch(std::span<const uint32_t> queries, std::span<std::optional<uint32_t>> out) const
+    {
+        assert(out.size() >= queries.size());
+
+        uint32_t lower[kBatch];
+        uint32_t upper[kBatch];
+        for (size_t first = 0; first < queries.size(); first += kBatch) {
+            const size_t count = std::min(kBatch, queries.size() - first);
+            FuzzyBounds(queries.data() + first, count, lower, upper);
+
+            auto block = out.subspan(first, count);
+            layout_.LowerBoundBatch(std::span<const uint32_t>(lower, count), block);
+            for (size_t j = 0; j < count; ++j) {
+                if (block[j] && *block[j] > upper[j]) {
+                    block[j].reset();
+                }
+            }
+        }
+    }
+
+    // ------------------------------------------------
+    // Range queries
+    // ------------------------------------------------
+    //
+    // These need the keys as one sorted array (layouts with Data()), and
+    // cost two binary searches regardless of how many keys match.
+
+    // Every stored key in [ceil(x / 2), 2x], in order, duplicates included.
+    // The span points into the layout and lives as long as it does.
+    std::span<const uint32_t> FindAll(uint32_t x) const
+        requires requires(const Layout& layout) { layout.Data(); }
+    {
+        const std::span<const uint32_t> data = layout_.Data();
+        auto first = std::lower_bound(data.begin(), data.end(), FuzzyLower(x));
+        auto last = std::upper_bound(first, data.end(), FuzzyUpper(x));
+        return data.subspan(static_cast<size_t>(first - data.begin()), static_cast<size_t>(last - first));
+    }
+
+    size_t Count(uint32_t x) const
+        requires requires(const Layout& layout) { layout.Data(); }
+    {
+        return FindAll(x).size();
+    }
+
+    // The key in [ceil(x / 2), 2x] closest to x; the smaller one on a tie.
+    // x itself is always inside its range, so only the stored neighbours
+    // on either side of x can be the answer.
+    std::optional<uint32_t> FindNearest(uint32_t x) const
+        requires requires(const Layout& layout) { layout.Data(); }
+    {
+        const std::span<const uint32_t> data = layout_.Data();
+        auto it = std::lower_bound(data.begin(), data.end(), x);
+
+        std::optional<uint32_t> above;
+        if (it != data.end() && *it <= FuzzyUpper(x)) {
+            above = *it;
+        }
+        if (it != data.begin() && *(it - 1) >= FuzzyLower(x)) {
+            const uint32_t below = *(it - 1);
+            if (!above || x - below <= *above - x) {
+                return below;
+            }
+        }
+        return above;
+    }
+
+    // Only available when the layout can be modified in place.
+    void Insert(uint32_t key)
+        requires requires(Layout& layout) { layout.Insert(key); }
+    {
+        layout_.Insert(key);
+    }
+
+    // Removes one occurrence of key; returns false if it was not stored.
+    bool Erase(uint32_t key)
+        requires requires(Layout& layout) { layout.Erase(key); }
+    {
+        return layout_.Erase(key);
+    }
+
+    const Layout& layout() const { return layout_; }
+
+private:
+    static constexpr size_t kBatch = 256;
+
+    static std::vector<uint32_t> SortedCopy(std::vector<uint32_t> data)
+    {
+        std::sort(data.begin(), data.end());
+        return data;
+    }
+
+    static std::vector<uint32_t> SortedInPlace(std::vector<uint32_t>&& data, unsigned threads)
+    {
+        if (threads > 1) {
+            ParallelRadixSort(data, threads);
+        } else {
+            std::sort(data.begin(), data.end());
+        }
+        return std::move(data);
+    }
+
+    Layout layout_;
+};
+
+using FuzzySearch = BasicFuzzySearch<SortedLayout>;
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "fuzzy_search.h"
+#include "eytzinger_layout.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ----------------------------------------------------
+// On-disk FuzzySearch index
+// ----------------------------------------------------
+//
+// File layout (native byte order, checked through `byte_order`):
+//
+//   [0, 64)             IndexHeader, zero padded
+//   [64, 64 + 4 * m)    payload: m uint32_t keys
+//
+// For IndexLayout::Sorted the payload is the sorted keys (m = count). For
+// IndexLayout::Eytzinger it is the Eytzinger array including its unused
+// slot 0 (m = count + 1). The payload starts on a cache line boundary, so
+// the mapped Eytzinger array keeps the alignment its prefetching relies on.
+//
+// MappedFuzzySearch maps the file read-only and MAP_SHARED: startup costs
+// one mmap, pages are faulted in on demand, and every process serving the
+// same file shares one copy in the page cache.
+
+enum class IndexLayout : uint32_t {
+    Sorted = 0,
+    Eytzinger = 1,
+};
+
+struct IndexHeader {
+    static constexpr char kMagic[8] = {'F', 'Z', 'S', 'I', 'D', 'X', '\0', '\0'};
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kByteOrder = 0x01020304;
+    static constexpr uint64_t kPayloadOffset = 64;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t layout;
+    uint32_t reserved;
+    uint64_t count;          // number of keys
+    uint64_t payload_offset; // bytes from the start of the file
+    uint64_t payload_size;   // number of uint32_t in the payload
+};
+
+static_assert(sizeof(IndexHeader) <= IndexHeader::kPayloadOffset);
+
+// Builds the index for `keys` (any order) and writes it to `path`. The file
+// is written next to `path` and renamed into place, so processes that have
+// the old file mapped keep a consistent view.
+inline void WriteFuzzyIndex(const std::string& path, std::vector<uint32_t> keys, IndexLayout layout)
+{
+    std::sort(keys.begin(), keys.end());
+
+    std::span<const uint32_t> payload = keys;
+    std::optional<EytzingerLayout> eytzinger;
+    if (layout == IndexLayout::Eytzinger) {
+        eytzinger.emplace(keys);
+        payload = eytzinger->View().Tree();
+    }
+
+    IndexHeader header{};
+    std::memcpy(header.magic, IndexHeader::kMagic, sizeof(header.magic));
+    header.version = IndexHeader::kVersion;
+    header.byte_order = IndexHeader::kByteOrder;
+    header.layout = static_cast<uint32_t>(layout);
+    header.count = keys.size();
+    header.payload_offset = IndexHeader::kPayloadOffset;
+    header.payload_size = payload.size();
+
+    char head[IndexHeader::kPayloadOffset] = {};
+    std::memcpy(head, &header, sizeof(header));
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(head, sizeof(head));
+        out.write(reinterpret_cast<const char*>(payload.data()),
+                  static_cast<std::streamsize>(payload.size_bytes()));
+        if (!out) {
+            throw std::runtime_error("WriteFuzzyIndex: cannot write " + tmp);
+        }
+    }
+    std::filesystem::rename(tmp, path);
+}
+
+class MappedFuzzySearch
+{
+public:
+    // Maps `path` and validates its header. Throws std::system_error if the
+    // file cannot be opened or mapped, std::runtime_error if it is not a
+    // valid index.
+    explicit MappedFuzzySearch(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "fstat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ < IndexHeader::kPayloadOffset) {
+            ::close(fd);
+            throw std::runtime_error(path + ": too small for an index");
+        }
+
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        const int err = errno;
+        ::close(fd); // the mapping keeps the file alive
+        if (addr == MAP_FAILED) {
+            throw std::system_error(err, std::generic_category(), "mmap " + path);
+        }
+        base_ = addr;
+
+        // Lookups jump around; don't let readahead pull in neighbours
+        ::madvise(base_, size_, MADV_RANDOM);
+
+        try {
+            Validate(path);
+        } catch (...) {
+            ::munmap(base_, size_);
+            throw;
+        }
+    }
+
+    MappedFuzzySearch(const MappedFuzzySearch&) = delete;
+    MappedFuzzySearch& operator=(const MappedFuzzySearch&) = delete;
+
+    MappedFuzzySearch(MappedFuzzySearch&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , search_(std::move(other.search_))
+    {
+    }
+
+    MappedFuzzySearch& operator=(MappedFuzzySearch&&) = delete;
+
+    ~MappedFuzzySearch()
+    {
+        if (base_ != nullptr) {
+            ::munmap(base_, size_);
+        }
+    }
+
+    std::optional<uint32_t> Find(uint32_t x) const
+    {
+        return std::visit([x](const auto& search) { return search.Find(x); }, search_);
+    }
+
+    void FindBatch(std::span<const uint32_t> queries, std::span<std::optional<uint32_t>> out) const
+    {
+        std::visit([&](const auto& search) { search.FindBatch(queries, out); }, search_);
+    }
+
+    // Asks the kernel to read the whole payload in now rather than on first
+    // touch; useful right after startup on a cold page cache.
+    void WillNeed() const { ::madvise(base_, size_, MADV_WILLNEED); }
+
+    IndexLayout Layout() const { return static_cast<IndexLayout>(Header().layout); }
+
+    size_t Size() const { return Header().count; }
+
+private:
+    const IndexHeader& Header() const { return *static_cast<const IndexHeader*>(base_); }
+
+    void Validate(const std::string& path)
+    {
+        const IndexHeader& header = Header();
+        if (std::memcmp(header.magic, IndexHeader::kMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error(path + ": not a FuzzySearch index");
+        }
+        if (header.version != IndexHeader::kVersion) {
+            throw std::runtime_error(path + ": unsupported index version " + std::to_string(header.version));
+        }
+        if (header.byte_order != IndexHeader::kByteOrder) {
+            throw std::runtime_error(path + ": index was written with a different byte order");
+        }
+        if (header.payload_offset != IndexHeader::kPayloadOffset
+            || header.payload_size > (size_ - header.payload_offset) / sizeof(uint32_t)) {
+            throw std::runtime_error(path + ": truncated index");
+        }
+
+        // From here on count is checked against payload_size, which the
+        // mapped size bounds, so it also fits the layouts' size_t
+        const uint32_t* payload = reinterpret_cast<const uint32_t*>(static_cast<const char*>(base_) + header.payload_offset);
+        switch (static_cast<IndexLayout>(header.layout)) {
+        case IndexLayout::Sorted:
+            if (header.payload_size != header.count) {
+                throw std::runtime_error(path + ": payload size does not match key count");
+            }
+            search_.emplace<BasicFuzzySearch<SortedViewLayout>>(SortedViewLayout(payload, header.count));
+            break;
+        case IndexLayout::Eytzinger:
+            // payload_size - 1, not count + 1: a count of UINT64_MAX would
+            // wrap to a payload of 0 and pass
+            if (header.payload_size == 0 || header.payload_size - 1 != header.count) {
+                throw std::runtime_error(path + ": payload size does not match key count");
+            }
+            search_.emplace<BasicFuzzySearch<EytzingerViewLayout>>(EytzingerViewLayout(payload, header.count));
+            break;
+        default:
+            throw std::runtime_error(path + ": unknown layout " + std::to_string(header.layout));
+        }
+    }
+
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    std::variant<BasicFuzzySearch<SortedViewLayout>, BasicFuzzySearch<EytzingerViewLayout>> search_{
+        std::in_place_index<0>, SortedViewLayout(nullptr, 0)};
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ----------------------------------------------------
+// Parallel LSD radix sort for uint32_t keys
+// ----------------------------------------------------
+//
+// Four passes of 8 bits, least significant digit first. Each thread owns a
+// contiguous chunk of the input. In every pass it
+//
+//   1. counts the digits in its chunk,
+//   2. (thread 0 only) turns all counts into write offsets, digit-major and
+//      thread-minor, so that the scatter is stable,
+//   3. scatters its chunk into the other buffer.
+//
+// Steps are separated by a barrier; the threads live for the whole sort.
+// A pass whose digit is the same for every key (e.g. the high byte of small
+// keys) is skipped.
+//
+// Needs one scratch buffer of keys.size() words; small inputs go to
+// std::sort instead.
+inline void ParallelRadixSort(std::vector<uint32_t>& keys, unsigned threads)
+{
+    constexpr unsigned kDigitBits = 8;
+    constexpr size_t kBuckets = size_t{1} << kDigitBits;
+    constexpr unsigned kPasses = 32 / kDigitBits;
+    // Below this a thread's chunk is not worth a scatter pass
+    constexpr size_t kMinPerThread = 1 << 16;
+
+    const size_t n = keys.size();
+    if (n < kMinPerThread) {
+        std::sort(keys.begin(), keys.end());
+        return;
+    }
+    threads = static_cast<unsigned>(std::clamp<size_t>(threads, 1, n / kMinPerThread));
+
+    // Not value-initialized: every word is written before it is read
+    std::unique_ptr<uint32_t[]> scratch(new uint32_t[n]);
+    std::vector<std::array<size_t, kBuckets>> counts(threads);
+    bool skip = false;
+    std::barrier sync(static_cast<std::ptrdiff_t>(threads));
+
+    auto worker = [&](unsigned t) {
+        const size_t begin = n * t / threads;
+        const size_t end = n * (t + 1) / threads;
+        uint32_t* src = keys.data();
+        uint32_t* dst = scratch.get();
+
+        for (unsigned pass = 0; pass < kPasses; ++pass) {
+            const unsigned shift = pass * kDigitBits;
+            auto& count = counts[t];
+            count.fill(0);
+            for (size_t i = begin; i < end; ++i) {
+                ++count[(src[i] >> shift) & (kBuckets - 1)];
+            }
+            sync.arrive_and_wait();
+
+            if (t == 0) {
+                size_t offset = 0;
+                skip = false;
+                for (size_t d = 0; d < kBuckets; ++d) {
+                    const size_t digit_begin = offset;
+                    for (auto& c : counts) {
+                        const size_t k = c[d];
+                        c[d] = offset;
+                        offset += k;
+                    }
+                    skip = skip || (offset - digit_begin == n);
+                }
+            }
+            sync.arrive_and_wait();
+
+            if (skip) {
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t key = src[i];
+                dst[count[(key >> shift) & (kBuckets - 1)]++] = key;
+            }
+            std::swap(src, dst);
+            // Next pass reads what other threads just wrote
+            sync.arrive_and_wait();
+        }
+
+        // An odd number of scatters leaves the result in the scratch buffer
+        if (src != keys.data()) {
+            std::memcpy(keys.data() + begin, src + begin, (end - begin) * sizeof(uint32_t));
+        }
+    };
+
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// ----------------------------------------------------
+// RadixSpline layout: learned position model
+// ----------------------------------------------------
+//
+// The sorted keys stay as they are; next to them we keep a model of their
+// CDF (key -> position of its first occurrence):
+//
+//   * a linear spline built with the greedy spline corridor, so that for
+//     every stored key the interpolated position is within MaxError of the
+//     real one;
+//   * a radix table on the top RadixBits bits of (key - min) that narrows
+//     down which spline segment covers a key.
+//
+// LowerBound interpolates a position and finishes with a branchless binary
+// search over [pred - MaxError, pred + MaxError]. If the answer turns out to
+// lie outside that window (possible for keys that are not stored, e.g. right
+// after a long run of duplicates) it gallops outwards from the window edge,
+// so the result is always exact; the model only decides how fast it is.
+template <size_t MaxError = 32, unsigned RadixBits = 18>
+class RadixSplineLayout
+{
+public:
+    explicit RadixSplineLayout(std::vector<uint32_t> sorted)
+        : data_(std::move(sorted))
+    {
+        if (data_.empty()) {
+            return;
+        }
+        BuildSpline();
+        BuildRadixTable();
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const
+    {
+        const size_t n = data_.size();
+        if (n == 0 || key > data_.back()) {
+            return std::nullopt;
+        }
+        if (key <= data_.front()) {
+            return data_.front();
+        }
+        return data_[Search(key, Predict(key))];
+    }
+
+    // Predict every position first and prefetch it, then run the short
+    // bounded searches.
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        for (size_t first = 0; first < keys.size(); first += kLanes) {
+            const size_t lanes = std::min(kLanes, keys.size() - first);
+
+            size_t pred[kLanes];
+            for (size_t j = 0; j < lanes; ++j) {
+                const uint32_t key = keys[first + j];
+                if (data_.empty() || key <= data_.front() || key > data_.back()) {
+                    pred[j] = kNoPrediction;
+                    continue;
+                }
+                pred[j] = Predict(key);
+                __builtin_prefetch(data_.data() + pred[j]);
+            }
+
+            for (size_t j = 0; j < lanes; ++j) {
+                if (pred[j] == kNoPrediction) {
+                    out[first + j] = LowerBound(keys[first + j]);
+                } else {
+                    out[first + j] = data_[Search(keys[first + j], pred[j])];
+                }
+            }
+        }
+    }
+
+    std::span<const uint32_t> Data() const { return data_; }
+
+    size_t Size() const { return data_.size(); }
+
+    size_t SplinePoints() const { return spline_.size(); }
+
+    size_t MemoryBytes() const
+    {
+        return data_.size() * sizeof(uint32_t) + spline_.size() * sizeof(Point)
+             + radix_table_.size() * sizeof(uint32_t);
+    }
+
+private:
+    static constexpr size_t kLanes = 32;
+    static constexpr size_t kNoPrediction = SIZE_MAX;
+
+    struct Point {
+        uint32_t key;
+        uint32_t pos; // position of the first occurrence of key
+    };
+
+    // ------------------------------------------------
+    // Model
+    // ------------------------------------------------
+
+    // Greedy spline corridor: keep extending the current segment from
+    // `base` while every point seen so far fits between the lines through
+    // `upper` and `lower` (the last points' position +/- MaxError).
+    void BuildSpline()
+    {
+        std::vector<Point> points;
+        for (size_t i = 0; i < data_.size(); ++i) {
+            if (i == 0 || data_[i] != data_[i - 1]) {
+                points.push_back({data_[i], static_cast<uint32_t>(i)});
+            }
+        }
+
+        spline_.push_back(points[0]);
+        if (points.size() == 1) {
+            return;
+        }
+
+        const double err = static_cast<double>(MaxError);
+        Point base = points[0];
+        Point prev = points[1];
+        double upper_x = points[1].key, upper_y = points[1].pos + err;
+        double lower_x = points[1].key, lower_y = points[1].pos - err;
+
+        // > 0 if (x, y) lies to the left of (above) the line base -> (lx, ly)
+        auto cross = [&base](double lx, double ly, double x, double y) {
+            const double bx = base.key, by = base.pos;
+            return (lx - bx) * (y - by) - (ly - by) * (x - bx);
+        };
+
+        for (size_t i = 2; i < points.size(); ++i) {
+            const Point p = points[i];
+            const double px = p.key, py = p.pos;
+            if (cross(upper_x, upper_y, px, py) > 0 || cross(lower_x, lower_y, px, py) < 0) {
+                // p leaves the corridor: close the segment at the previous point
+                spline_.push_back(prev);
+                base = prev;
+                upper_x = lower_x = px;
+                upper_y = py + err;
+                lower_y = py - err;
+            } else {
+                if (cross(upper_x, upper_y, px, py + err) < 0) {
+                    upper_x = px;
+                    upper_y = py + err;
+                }
+                if (cross(lower_x, lower_y, px, py - err) > 0) {
+                    lower_x = px;
+                    lower_y = py - err;
+                }
+            }
+            prev = p;
+        }
+        spline_.push_back(points.back());
+    }
+
+    void BuildRadixTable()
+    {
+        min_ = data_.front();
+        const uint32_t range = data_.back() - min_;
+        const unsigned bits = static_cast<unsigned>(std::bit_width(range));
+        // No point in many more buckets than there are spline points
+        const unsigned radix_bits = std::min<unsigned>(RadixBits, std::bit_width(spline_.size()) + 4);
+        shift_ = bits > radix_bits ? bits - radix_bits : 0;
+
+        // radix_table_[p] = first spline point whose prefix is >= p
+        const size_t prefixes = (static_cast<size_t>(range) >> shift_) + 1;
+        radix_table_.assign(prefixes + 1, static_cast<uint32_t>(spline_.size()));
+        size_t next = 0;
+        for (size_t i = 0; i < spline_.size(); ++i) {
+            const size_t prefix = (spline_[i].key - min_) >> shift_;
+            while (next <= prefix) {
+                radix_table_[next++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+
+    // Interpolated position of key; requires front < key <= back.
+    size_t Predict(uint32_t key) const
+    {
+        const size_t prefix = (key - min_) >> shift_;
+        const size_t begin = radix_table_[prefix];
+        const size_t end = std::min<size_t>(radix_table_[prefix + 1] + 1, spline_.size());
+
+        // First spline point >= key; key > front keeps it past point 0
+        const size_t right = begin + BranchlessLowerBound(spline_.data() + begin, end - begin, key,
+                                                          [](const Point& p) { return p.key; });
+        const Point& a = spline_[right - 1];
+        const Point& b = spline_[right];
+
+        const double slope = static_cast<double>(b.pos - a.pos) / static_cast<double>(b.key - a.key);
+        const double pos = a.pos + slope * static_cast<double>(key - a.key);
+        return std::min(static_cast<size_t>(pos), data_.size() - 1);
+    }
+
+    // Index of the first element of [first, first + len) whose projection
+    // is >= key. The window is short and its outcome random, so a fixed
+    // number of conditional moves beats a predicted branch per step.
+    template <typename T, typename Proj>
+    static size_t BranchlessLowerBound(const T* first, size_t len, uint32_t key, Proj proj)
+    {
+        if (len == 0) {
+            return 0;
+        }
+        const T* base = first;
+        while (len > 1) {
+            const size_t half = len / 2;
+            base += (proj(base[half - 1]) < key) * half;
+            len -= half;
+        }
+        return static_cast<size_t>(base - first) + (proj(*base) < key);
+    }
+
+    // lower_bound of key around pred; requires front < key <= back.
+    size_t Search(uint32_t key, size_t pred) const
+    {
+        const size_t n = data_.size();
+        const uint32_t* data = data_.data();
+        auto identity = [](uint32_t v) { return v; };
+
+        const size_t lo = pred > MaxError ? pred - MaxError : 0;
+        const size_t hi = std::min(n, pred + MaxError + 2);
+        const size_t pos = lo + BranchlessLowerBound(data + lo, hi - lo, key, identity);
+        if (pos == lo && lo > 0 && data[lo - 1] >= key) {
+            // Gallop left; invariant: data[right] >= key
+            size_t right = lo - 1;
+            size_t step = 1;
+            while (step <= right && data[right - step] >= key) {
+                right -= step;
+                step *= 2;
+            }
+            const size_t from = step <= right ? right - step + 1 : 0;
+            return from + BranchlessLowerBound(data + from, right - from + 1, key, identity);
+        }
+        if (pos == hi && hi < n) {
+            // Gallop right; invariant: everything before left is < key
+            size_t left = hi;
+            size_t step = 1;
+            while (left + step < n && data[left + step - 1] < key) {
+                left += step;
+                step *= 2;
+            }
+            const size_t to = std::min(n, left + step);
+            return left + BranchlessLowerBound(data + left, to - left, key, identity);
+        }
+        return pos;
+    }
+
+    std::vector<uint32_t> data_;
+    std::vector<Point> spline_;
+    std::vector<uint32_t> radix_table_;
+    uint32_t min_ = 0;
+    unsigned shift_ = 0;
+};
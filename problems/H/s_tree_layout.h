@@ -0,0 +1,166 @@
+#pragma once
+
+#include "aligned_allocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------
+// S-tree: static B-tree with 16-key nodes
+// ----------------------------------------------------
+//
+// Every node is one 64-byte cache line holding 16 sorted keys; node k has 17
+// children at k * 17 + 1 .. k * 17 + 17. A lookup touches one cache line per
+// level (log_17 n levels instead of log_2 n) and ranks the key inside a node
+// with two 8-wide SIMD compares instead of a chain of dependent branches.
+//
+// AVX2 only has signed 32-bit compares, so keys are stored with the sign bit
+// flipped, which maps unsigned order onto signed order.
+class STreeLayout
+{
+public:
+    explicit STreeLayout(const std::vector<uint32_t>& sorted)
+        : size_(sorted.size())
+        , nodes_((sorted.size() + kNode - 1) / kNode)
+        , tree_(nodes_ * kNode)
+        , has_max_(!sorted.empty() && sorted.back() == MAX_KEY)
+    {
+        size_t t = 0;
+        Build(sorted, t, 0);
+
+        // Nodes are numbered level by level, so the height is the number of
+        // levels needed to cover all node indices.
+        for (size_t level_begin = 0, level_size = 1; level_begin < nodes_; level_size *= kNode + 1) {
+            level_begin += level_size;
+            ++height_;
+        }
+    }
+
+    std::optional<uint32_t> LowerBound(uint32_t key) const
+    {
+        const int32_t biased = Bias(key);
+        bool found = false;
+        int32_t result = 0;
+
+        size_t k = 0;
+        while (k < nodes_) {
+            const size_t i = Rank(biased, &tree_[k * kNode]);
+            if (i < kNode) {
+                found = true;
+                result = tree_[k * kNode + i];
+            }
+            k = k * (kNode + 1) + i + 1;
+        }
+
+        // Tail padding is MAX_KEY, which sorts after every real key. Landing
+        // on it means nothing real is >= key, unless MAX_KEY is itself stored.
+        const uint32_t value = Unbias(result);
+        if (!found || (value == MAX_KEY && !has_max_)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // Lockstep version of LowerBound. Searches can end one level apart, so
+    // lanes that already fell off the tree just sit out the last level.
+    void LowerBoundBatch(std::span<const uint32_t> keys, std::span<std::optional<uint32_t>> out) const
+    {
+        for (size_t first = 0; first < keys.size(); first += kLanes) {
+            const size_t lanes = std::min(kLanes, keys.size() - first);
+
+            int32_t key[kLanes];
+            size_t k[kLanes];
+            int32_t result[kLanes];
+            bool found[kLanes];
+            for (size_t j = 0; j < lanes; ++j) {
+                key[j] = Bias(keys[first + j]);
+                k[j] = 0;
+                result[j] = 0;
+                found[j] = false;
+            }
+
+            for (size_t level = 0; level < height_; ++level) {
+                for (size_t j = 0; j < lanes; ++j) {
+                    if (k[j] >= nodes_) {
+                        continue;
+                    }
+                    const size_t i = Rank(key[j], &tree_[k[j] * kNode]);
+                    if (i < kNode) {
+                        found[j] = true;
+                        result[j] = tree_[k[j] * kNode + i];
+                    }
+                    k[j] = k[j] * (kNode + 1) + i + 1;
+                    if (k[j] < nodes_) {
+                        __builtin_prefetch(&tree_[k[j] * kNode]);
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < lanes; ++j) {
+                const uint32_t value = Unbias(result[j]);
+                out[first + j] = (!found[j] || (value == MAX_KEY && !has_max_)) ? std::nullopt
+                                                                                 : std::optional<uint32_t>(value);
+            }
+        }
+    }
+
+    size_t Size() const { return size_; }
+
+    size_t MemoryBytes() const { return tree_.size() * sizeof(int32_t); }
+
+private:
+    static constexpr size_t kNode = 16;
+    // Searches advanced together by LowerBoundBatch.
+    static constexpr size_t kLanes = 32;
+    static constexpr uint32_t MAX_KEY = 0xFFFFFFFFu;
+
+    static int32_t Bias(uint32_t x) { return static_cast<int32_t>(x ^ 0x80000000u); }
+    static uint32_t Unbias(int32_t x) { return static_cast<uint32_t>(x) ^ 0x80000000u; }
+
+    // In-order fill: the keys of node k interleave with its subtrees.
+    void Build(const std::vector<uint32_t>& sorted, size_t& t, size_t k)
+    {
+        if (k < nodes_) {
+            for (size_t i = 0; i < kNode; ++i) {
+                Build(sorted, t, k * (kNode + 1) + i + 1);
+                tree_[k * kNode + i] = Bias(t < sorted.size() ? sorted[t++] : MAX_KEY);
+            }
+            Build(sorted, t, k * (kNode + 1) + kNode + 1);
+        }
+    }
+
+    // Number of keys in the node that are < key.
+    static size_t Rank(int32_t key, const int32_t* node)
+    {
+#if defined(__AVX2__)
+        const __m256i x  = _mm256_set1_epi32(key);
+        const __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+        const __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8));
+        const __m256i lt_lo = _mm256_cmpgt_epi32(x, lo);
+        const __m256i lt_hi = _mm256_cmpgt_epi32(x, hi);
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lt_lo)))
+                            | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lt_hi))) << 8;
+        return static_cast<size_t>(__builtin_popcount(mask));
+#else
+        size_t count = 0;
+        for (size_t i = 0; i < kNode; ++i) {
+            count += (node[i] < key);
+        }
+        return count;
+#endif
+    }
+
+    size_t size_;
+    size_t nodes_;
+    std::vector<int32_t, AlignedAllocator<int32_t>> tree_;
+    bool has_max_;
+    size_t height_ = 0;
+};
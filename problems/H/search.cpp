@@ -1,41 +1,13 @@
+#include "fuzzy_search.h"
+
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <cstdint>
-#include <optional>
-#include <limits>
 #include <cassert>
 #include <cstdlib>
 #include <ctime>
 
-static constexpr uint32_t HALF_MAX = std::numeric_limits<uint32_t>::max() / 2;
-static constexpr uint32_t MAX_VAL  = std::numeric_limits<uint32_t>::max();
-
-class FuzzySearch
-{
-public:
-    explicit FuzzySearch(const std::vector<uint32_t>& input)
-    {
-        data_ = input;
-        std::sort(data_.begin(), data_.end());
-    }
-
-    std::optional<uint32_t> Find(uint32_t x) const
-    {
-        const uint32_t lower = (x >> 1) + (x & 1); // ceiling of x / 2 for any x, avoiding potential overflow from doing x + 1
-        const uint32_t upper = (x > HALF_MAX) ? MAX_VAL : (x << 1); // probably this can be done without branches
-
-        auto it = std::lower_bound(data_.begin(), data_.end(), lower);
-        if (it != data_.end() && *it <= upper) {
-            return *it;
-        }
-        return std::nullopt;
-    }
-
-private:
-    std::vector<uint32_t> data_;
-};
-
 int main()
 {
     std::vector<uint32_t> arr = {0, 1, 2147483647, 2147483648, 4294967295};
@@ -0,0 +1,375 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_data.h"
+#include "fuzzy_search.h"
+#include "eytzinger_layout.h"
+#include "s_tree_layout.h"
+#include "b_tree_layout.h"
+#include "concurrent_fuzzy_search.h"
+#include "mapped_fuzzy_search.h"
+#include "compressed_layout.h"
+#include "radix_spline_layout.h"
+#include "radix_sort.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// DATA
+// -----------------------------------------------------------------------------
+
+// Queries are generated up front so the loop only measures Find.
+static constexpr size_t kQueries = 1 << 16;
+
+// -----------------------------------------------------------------------------
+// BENCHMARKS
+// -----------------------------------------------------------------------------
+
+// Per-query Find cost; state.range(0) is the number of stored keys.
+template <typename Layout>
+static void BM_Find(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    BasicFuzzySearch<Layout> searcher(RandomKeys(n, 42));
+    const std::vector<uint32_t> queries = RandomKeys(kQueries, 7);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searcher.Find(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if constexpr (requires { searcher.layout().MemoryBytes(); }) {
+        state.counters["bytes_per_key"] = static_cast<double>(searcher.layout().MemoryBytes()) / static_cast<double>(n);
+    }
+}
+
+// 1K keys (L1) .. 64M keys (256 MB, DRAM)
+BENCHMARK_TEMPLATE(BM_Find, SortedLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_Find, EytzingerLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_Find, STreeLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_Find, BTreeLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_Find, CompressedLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_Find, RadixSplineLayout<>)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+
+// Layout lookups on skewed data; args are {keys, KeyDistribution}. Half the
+// queries are stored keys, half fresh draws from the same distribution, and
+// they go straight to LowerBound so the fuzzy bounds don't reshape them.
+template <typename Layout>
+static void BM_LowerBound(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto dist = static_cast<KeyDistribution>(state.range(1));
+    std::vector<uint32_t> keys = DistributedKeys(n, dist, 42);
+
+    std::vector<uint32_t> queries = DistributedKeys(kQueries, dist, 7);
+    std::mt19937 rng{11};
+    for (size_t i = 0; i < kQueries; i += 2) {
+        queries[i] = keys[rng() % n];
+    }
+
+    std::sort(keys.begin(), keys.end());
+    const Layout layout(keys);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(layout.LowerBound(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if constexpr (requires { layout.MemoryBytes(); }) {
+        state.counters["bytes_per_key"] = static_cast<double>(layout.MemoryBytes()) / static_cast<double>(n);
+    }
+}
+
+static void DistributionArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgsProduct({{1 << 10, 1 << 16, 1 << 20, 1 << 24},
+                    {static_cast<int>(KeyDistribution::Uniform), static_cast<int>(KeyDistribution::Lognormal),
+                     static_cast<int>(KeyDistribution::Clustered)}});
+}
+
+BENCHMARK_TEMPLATE(BM_LowerBound, SortedLayout)->Apply(DistributionArgs);
+BENCHMARK_TEMPLATE(BM_LowerBound, EytzingerLayout)->Apply(DistributionArgs);
+BENCHMARK_TEMPLATE(BM_LowerBound, STreeLayout)->Apply(DistributionArgs);
+// Error bound trade-off: tighter corridor = more spline points, shorter
+// last-mile search
+BENCHMARK_TEMPLATE(BM_LowerBound, RadixSplineLayout<8>)->Apply(DistributionArgs);
+BENCHMARK_TEMPLATE(BM_LowerBound, RadixSplineLayout<32>)->Apply(DistributionArgs);
+BENCHMARK_TEMPLATE(BM_LowerBound, RadixSplineLayout<128>)->Apply(DistributionArgs);
+
+// Range queries: two binary searches each, whatever the match count.
+// On uniform keys [x/2, 2x] holds a sizeable fraction of the data, so
+// the linear rescan these replace would be O(n) per query.
+static void BM_Count(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    FuzzySearch searcher(RandomKeys(n, 42));
+    const std::vector<uint32_t> queries = RandomKeys(kQueries, 7);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searcher.Count(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_FindNearest(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    FuzzySearch searcher(RandomKeys(n, 42));
+    const std::vector<uint32_t> queries = RandomKeys(kQueries, 7);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searcher.FindNearest(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Count)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK(BM_FindNearest)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+
+// Update cost of the dynamic layout at a steady size: each iteration erases
+// a stored key and inserts it back (two updates).
+static void BM_EraseInsert(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const std::vector<uint32_t> keys = RandomKeys(n, 42);
+    DynamicFuzzySearch searcher(keys);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        searcher.Erase(keys[idx]);
+        searcher.Insert(keys[idx]);
+        idx = (idx + 1) % n;
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_EraseInsert)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+
+// Throughput over a block of queries: scalar Find loop vs FindBatch.
+static constexpr size_t kBlockQueries = 4096;
+
+template <typename Layout>
+static void BM_FindLoop(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    BasicFuzzySearch<Layout> searcher(RandomKeys(n, 42));
+    const std::vector<uint32_t> queries = RandomKeys(kBlockQueries, 7);
+    std::vector<std::optional<uint32_t>> out(kBlockQueries);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < kBlockQueries; ++i) {
+            out[i] = searcher.Find(queries[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kBlockQueries);
+}
+
+template <typename Layout>
+static void BM_FindBatch(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    BasicFuzzySearch<Layout> searcher(RandomKeys(n, 42));
+    const std::vector<uint32_t> queries = RandomKeys(kBlockQueries, 7);
+    std::vector<std::optional<uint32_t>> out(kBlockQueries);
+
+    for (auto _ : state) {
+        searcher.FindBatch(queries, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kBlockQueries);
+}
+
+BENCHMARK_TEMPLATE(BM_FindLoop, SortedLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindBatch, SortedLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindLoop, EytzingerLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindBatch, EytzingerLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindLoop, STreeLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindBatch, STreeLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindLoop, CompressedLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+BENCHMARK_TEMPLATE(BM_FindBatch, CompressedLayout)->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+
+// Read scaling: many threads calling Find on one shared index.
+// 16M keys, so the index lives in DRAM.
+static constexpr size_t kSharedKeys = 1 << 24;
+
+static ConcurrentFuzzySearch<>& SharedConcurrentIndex()
+{
+    static ConcurrentFuzzySearch<> index(std::make_unique<FuzzySearch>(RandomKeys(kSharedKeys, 42)));
+    return index;
+}
+
+// The old way: one FuzzySearch behind a mutex
+static void BM_MutexFind(benchmark::State& state)
+{
+    static std::mutex mutex;
+    static FuzzySearch searcher(RandomKeys(kSharedKeys, 42));
+    const std::vector<uint32_t> queries = RandomKeys(kQueries, 7 + state.thread_index());
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        benchmark::DoNotOptimize(searcher.Find(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// state.range(0) == 1 adds a background writer that keeps publishing fresh
+// snapshots, so readers also pay for the churn.
+static void BM_ConcurrentFind(benchmark::State& state)
+{
+    auto& index = SharedConcurrentIndex();
+    static std::atomic<bool> stop_writer;
+    static std::thread writer;
+    if (state.thread_index() == 0 && state.range(0) == 1) {
+        stop_writer = false;
+        writer = std::thread([&index]() {
+            // Same size as the initial snapshot, refreshed ten times a second
+            const std::vector<uint32_t> keys = RandomKeys(kSharedKeys, 43);
+            while (!stop_writer.load(std::memory_order_relaxed)) {
+                index.Publish(std::make_unique<FuzzySearch>(keys));
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        });
+    }
+
+    auto reader = index.RegisterReader();
+    const std::vector<uint32_t> queries = RandomKeys(kQueries, 7 + state.thread_index());
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reader.Find(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0 && state.range(0) == 1) {
+        stop_writer = true;
+        writer.join();
+    }
+}
+
+BENCHMARK(BM_MutexFind)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentFind)->Arg(0)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ConcurrentFind)->Arg(1)->ThreadRange(1, 64)->UseRealTime();
+
+// Startup: building from a raw vector vs mapping a prebuilt index file.
+static std::string IndexPath(size_t n, IndexLayout layout)
+{
+    return (std::filesystem::temp_directory_path()
+            / ("fuzzy_search_bench_" + std::to_string(n) + "_" + std::to_string(static_cast<int>(layout)) + ".idx"))
+        .string();
+}
+
+static void BM_BuildFromVector(benchmark::State& state)
+{
+    const std::vector<uint32_t> keys = RandomKeys(static_cast<size_t>(state.range(0)), 42);
+    for (auto _ : state) {
+        FuzzySearch searcher(keys);
+        benchmark::DoNotOptimize(searcher);
+    }
+}
+
+static void BM_OpenMapped(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const std::string path = IndexPath(n, IndexLayout::Sorted);
+    WriteFuzzyIndex(path, RandomKeys(n, 42), IndexLayout::Sorted);
+    for (auto _ : state) {
+        MappedFuzzySearch searcher(path);
+        benchmark::DoNotOptimize(searcher);
+    }
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_BuildFromVector)->RangeMultiplier(8)->Range(1 << 16, 1 << 26)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OpenMapped)->RangeMultiplier(8)->Range(1 << 16, 1 << 26)->Unit(benchmark::kMillisecond);
+
+// Rebuild cost vs thread count; args are {keys, threads}. The input is
+// refilled outside the timed region and handed over by rvalue, so only the
+// sort and the layout build are measured. threads == 1 is std::sort.
+static void BM_BuildInPlace(benchmark::State& state)
+{
+    const std::vector<uint32_t> keys = RandomKeys(static_cast<size_t>(state.range(0)), 42);
+    const unsigned threads = static_cast<unsigned>(state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<uint32_t> input = keys;
+        state.ResumeTiming();
+        FuzzySearch searcher(std::move(input), threads);
+        benchmark::DoNotOptimize(searcher);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The radix sort alone, including its single-threaded speed
+static void BM_RadixSort(benchmark::State& state)
+{
+    const std::vector<uint32_t> keys = RandomKeys(static_cast<size_t>(state.range(0)), 42);
+    const unsigned threads = static_cast<unsigned>(state.range(1));
+    std::vector<uint32_t> input;
+    for (auto _ : state) {
+        state.PauseTiming();
+        input = keys;
+        state.ResumeTiming();
+        ParallelRadixSort(input, threads);
+        benchmark::DoNotOptimize(input.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void ThreadCountArgs(benchmark::internal::Benchmark* b)
+{
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int n : {1 << 20, 1 << 24, 1 << 26}) {
+        for (int threads = 1; threads < cores; threads *= 2) {
+            b->Args({n, threads});
+        }
+        b->Args({n, cores});
+    }
+}
+
+BENCHMARK(BM_BuildInPlace)->Apply(ThreadCountArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RadixSort)->Apply(ThreadCountArgs)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Find served straight from the mapping (page cache warm)
+static void BM_MappedFind(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto layout = static_cast<IndexLayout>(state.range(1));
+    const std::string path = IndexPath(n, layout);
+    WriteFuzzyIndex(path, RandomKeys(n, 42), layout);
+    MappedFuzzySearch searcher(path);
+    const std::vector<uint32_t> queries = RandomKeys(kQueries, 7);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searcher.Find(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_MappedFind)
+    ->ArgsProduct({{1 << 10, 1 << 16, 1 << 22, 1 << 26},
+                   {static_cast<int>(IndexLayout::Sorted), static_cast<int>(IndexLayout::Eytzinger)}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,706 @@
+#include "fuzzy_search.h"
+#include "eytzinger_layout.h"
+#include "s_tree_layout.h"
+#include "b_tree_layout.h"
+#include "concurrent_fuzzy_search.h"
+#include "mapped_fuzzy_search.h"
+#include "compressed_layout.h"
+#include "radix_spline_layout.h"
+#include "radix_sort.h"
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <limits>
+#include <random>
+#include <set>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <ctime>
+
+// ----------------------------------------------------
+// Simple "check" helper for pass/fail messages
+// ----------------------------------------------------
+static void check(bool condition, const std::string& testName)
+{
+    if (!condition)
+        std::cerr << "[FAILED] " << testName << "\n";
+    else
+        std::cout << "[PASSED] " << testName << "\n";
+}
+
+// ----------------------------------------------------
+// Test 1: Basic usage
+// ----------------------------------------------------
+template <typename Search = FuzzySearch>
+void testBasic(const std::string& testName = "testBasic")
+{
+    std::vector<uint32_t> inputs = {10, 1, 100, 2, 0, 16};
+    Search searcher(inputs);
+
+    // We'll mimic the example main() queries:
+    struct {
+        uint32_t query;
+        bool expectFound;
+    } testData[] = {
+        {0,  true},
+        {1,  true},
+        {2,  true},
+        {3,  true},
+        {8,  true},
+        {10, true},
+        {50, true},
+        {100,true},
+        {160,true},
+        {999999999, false}
+    };
+
+    bool allPassed = true;
+    for (auto& td : testData) {
+        auto result = searcher.Find(td.query);
+        bool gotValue = result.has_value();
+        if (gotValue != td.expectFound) {
+            allPassed = false;
+            break;
+        }
+    }
+
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 2: Single-element array
+// ----------------------------------------------------
+template <typename Search = FuzzySearch>
+void testSingleElementArray(const std::string& testName = "testSingleElementArray")
+{
+    // Only one element: 50
+    std::vector<uint32_t> inputs = {50};
+    Search searcher(inputs);
+
+    // Query exactly 50 => should find 50
+    auto r1 = searcher.Find(50);
+    bool pass1 = (r1.has_value() && r1.value() == 50u);
+
+    // Query smaller than half => (x+1)/2 won't include 50 => no match
+    auto r2 = searcher.Find(24); 
+    bool pass2 = (!r2.has_value());
+
+    // Query 100 => range is 50..200 => should find 50
+    auto r3 = searcher.Find(100);
+    bool pass3 = (r3.has_value() && r3.value() == 50u);
+
+    // Query 101 => range is 51..202 => 50 is out of range => no match
+    auto r4 = searcher.Find(101);
+    bool pass4 = (!r4.has_value());
+
+    bool allPassed = pass1 && pass2 && pass3 && pass4;
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 3: All zeros
+// ----------------------------------------------------
+template <typename Search = FuzzySearch>
+void testAllZeros(const std::string& testName = "testAllZeros")
+{
+    // All elements are zero
+    std::vector<uint32_t> inputs = {0, 0, 0, 0};
+    Search searcher(inputs);
+
+    // For x=0 => (0+1)/2=0..0 => should find zero
+    auto r0 = searcher.Find(0);
+    bool pass0 = (r0.has_value() && r0.value() == 0u);
+
+    // For x=1 => (1+1)/2=1..2 => lower_bound(1) => all zeros < 1 => no match
+    bool pass1 = (!searcher.Find(1).has_value());
+
+    // For x=2 => range is 1..4 => same reasoning => no match
+    bool pass2 = (!searcher.Find(2).has_value());
+
+    // For x=10 => range is 5..20 => no match
+    bool pass3 = (!searcher.Find(10).has_value());
+
+    bool allPassed = pass0 && pass1 && pass2 && pass3;
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 4: Large values & boundary checks
+// ----------------------------------------------------
+template <typename Search = FuzzySearch>
+void testLargeValues(const std::string& testName = "testLargeValues")
+{
+    uint32_t nearMax = std::numeric_limits<uint32_t>::max(); // 4294967295
+    uint32_t halfMax = nearMax / 2;                          // ~2147483647
+
+    // We'll store nearMax, halfMax, 0, 1
+    std::vector<uint32_t> inputs = {nearMax, halfMax, 0, 1};
+    Search searcher(inputs);
+
+    // 1) For x=nearMax => range is ceil(nearMax/2)..nearMax = (halfMax+1)..nearMax.
+    //    halfMax itself is just below the range, so the first element
+    //    >= halfMax+1 is nearMax, which is what we expect.
+    auto r1 = searcher.Find(nearMax);
+    bool pass1 = (r1.has_value() && r1.value() == nearMax);
+
+    // 2) For x=(halfMax - 10), let's see if we find halfMax or not.
+    //    range is ~((halfMax-10)+1)/2..(halfMax-10)*2 => 
+    //    That should include halfMax, so we expect that result.
+    uint32_t smallQuery = halfMax - 10;
+    auto r2 = searcher.Find(smallQuery);
+    bool pass2 = (r2.has_value() && r2.value() == halfMax);
+
+    // 3) For x=0 => range is 0..0 => we expect 0
+    auto r3 = searcher.Find(0);
+    bool pass3 = (r3.has_value() && r3.value() == 0u);
+
+    // 4) For x=1 => range is 1..2 => we expect to find 1
+    auto r4 = searcher.Find(1);
+    bool pass4 = (r4.has_value() && r4.value() == 1u);
+
+    bool allPassed = pass1 && pass2 && pass3 && pass4;
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 5: Random data
+// ----------------------------------------------------
+template <typename Search = FuzzySearch>
+void testRandomData(const std::string& testName = "testRandomData")
+{
+    // Create a random-ish dataset: multiples of 3 in [0..3000]
+    std::vector<uint32_t> inputs;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        inputs.push_back(i * 3);
+    }
+
+    // Shuffle them
+    std::srand(static_cast<unsigned>(std::time(nullptr)));
+    std::random_shuffle(inputs.begin(), inputs.end());
+
+    // Build the FuzzySearch index
+    Search searcher(inputs);
+
+    // We'll test 50 random queries in [0..3000]
+    bool allPassed = true;
+
+    for (int i = 0; i < 50; ++i) {
+        uint32_t query = static_cast<uint32_t>(std::rand() % 3001);
+        auto result = searcher.Find(query);
+
+        // Let's do a quick manual check: 
+        // If there's an element e in inputs in the range [(query+1)/2 .. min(query*2, MAX_VAL)],
+        // then we should expect result.has_value() == true. Otherwise false.
+
+        bool foundManually = false;
+        uint32_t lower = (query + 1) / 2;
+        uint32_t upper = (query > HALF_MAX) ? MAX_VAL : (query << 1);
+
+        for (auto e : inputs) {
+            if (e >= lower && e <= upper) {
+                foundManually = true;
+                break;
+            }
+        }
+
+        bool gotValue = result.has_value();
+        if (foundManually != gotValue) {
+            allPassed = false;
+            break;
+        }
+    }
+
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 6: Every layout agrees with the sorted-array reference
+// ----------------------------------------------------
+template <typename Search>
+void testMatchesReference(const std::string& testName)
+{
+    std::mt19937 rng{42};
+    bool allPassed = true;
+
+    // Sizes around the 16-key node / cache line boundaries, plus a bigger one
+    for (size_t n : {0, 1, 2, 15, 16, 17, 255, 256, 257, 1000, 100000}) {
+        std::vector<uint32_t> inputs(n);
+        for (auto& v : inputs) {
+            v = rng() % 4 == 0 ? rng() % 64 : rng();
+        }
+        if (n > 2) {
+            inputs[0] = 0;
+            inputs[1] = MAX_VAL;
+        }
+
+        FuzzySearch reference(inputs);
+        Search searcher(inputs);
+
+        std::vector<uint32_t> queries = {0, 1, 2, 3, HALF_MAX - 1, HALF_MAX, HALF_MAX + 1, MAX_VAL - 1, MAX_VAL};
+        for (int i = 0; i < 2000; ++i) {
+            queries.push_back(rng());
+            queries.push_back(rng() % 256);
+        }
+        for (auto v : inputs) {
+            queries.push_back(v);
+            queries.push_back(v * 2);
+            queries.push_back(v * 2 + 1);
+        }
+
+        for (auto q : queries) {
+            if (searcher.Find(q) != reference.Find(q)) {
+                allPassed = false;
+                break;
+            }
+        }
+    }
+
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 7: FindBatch returns exactly what Find returns
+// ----------------------------------------------------
+template <typename Search>
+void testFindBatch(const std::string& testName)
+{
+    std::mt19937 rng{7};
+    bool allPassed = true;
+
+    for (size_t n : {0, 1, 16, 17, 1000, 100000}) {
+        std::vector<uint32_t> inputs(n);
+        for (auto& v : inputs) {
+            v = rng();
+        }
+        if (n > 2) {
+            inputs[0] = 0;
+            inputs[1] = MAX_VAL;
+        }
+        Search searcher(inputs);
+
+        // Odd count so the SIMD bounds and the lane blocks both have a tail
+        std::vector<uint32_t> queries = {0, 1, 2, HALF_MAX, HALF_MAX + 1, MAX_VAL};
+        for (int i = 0; i < 1000; ++i) {
+            queries.push_back(rng());
+            queries.push_back(n == 0 ? 0 : inputs[rng() % n] * 2);
+        }
+        queries.push_back(3);
+
+        std::vector<std::optional<uint32_t>> out(queries.size());
+        searcher.FindBatch(queries, out);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            if (out[i] != searcher.Find(queries[i])) {
+                allPassed = false;
+                break;
+            }
+        }
+    }
+
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Test 8: Inserts and erases against a std::multiset model
+// ----------------------------------------------------
+void testDynamic()
+{
+    std::mt19937 rng{123};
+    bool allPassed = true;
+
+    // Small key range so that duplicates, re-inserts of erased keys and
+    // node merges all happen a lot
+    for (uint32_t range : {100u, 5000u, 0u}) {
+        auto nextKey = [&]() { return range == 0 ? static_cast<uint32_t>(rng()) : static_cast<uint32_t>(rng() % range); };
+
+        std::vector<uint32_t> initial(2000);
+        for (auto& v : initial) {
+            v = nextKey();
+        }
+        DynamicFuzzySearch searcher(initial);
+        std::multiset<uint32_t> model(initial.begin(), initial.end());
+
+        auto modelFind = [&](uint32_t x) -> std::optional<uint32_t> {
+            auto it = model.lower_bound(FuzzyLower(x));
+            if (it != model.end() && *it <= FuzzyUpper(x)) {
+                return *it;
+            }
+            return std::nullopt;
+        };
+
+        for (int step = 0; step < 200000 && allPassed; ++step) {
+            // Grow for a while, then shrink back down to empty
+            const bool grow = step < 100000 ? rng() % 3 != 0 : rng() % 3 == 0;
+            uint32_t key = nextKey();
+            if (grow) {
+                searcher.Insert(key);
+                model.insert(key);
+            } else {
+                // Half of the erases target a key that is actually stored
+                if (!model.empty() && rng() % 2 == 0) {
+                    auto it = model.lower_bound(key);
+                    key = (it != model.end()) ? *it : *model.begin();
+                }
+                auto it = model.find(key);
+                bool expected = it != model.end();
+                if (expected) {
+                    model.erase(it);
+                }
+                allPassed = allPassed && (searcher.Erase(key) == expected);
+            }
+
+            uint32_t query = rng() % 4 == 0 ? static_cast<uint32_t>(rng()) : nextKey() * 2;
+            allPassed = allPassed && (searcher.Find(query) == modelFind(query));
+            allPassed = allPassed && (searcher.layout().Size() == model.size());
+        }
+
+        // Drain whatever is left and check the tree is empty
+        std::vector<uint32_t> rest(model.begin(), model.end());
+        for (auto v : rest) {
+            allPassed = allPassed && searcher.Erase(v);
+        }
+        allPassed = allPassed && !searcher.Find(0).has_value() && !searcher.Find(MAX_VAL).has_value();
+        allPassed = allPassed && !searcher.Erase(0);
+    }
+
+    check(allPassed, "testDynamic");
+}
+
+// ----------------------------------------------------
+// Test 9: Readers racing with snapshot swaps
+// ----------------------------------------------------
+
+// FuzzySearch that counts live instances, to see snapshots being freed
+struct CountedSearch : FuzzySearch
+{
+    static inline std::atomic<int> live{0};
+
+    explicit CountedSearch(const std::vector<uint32_t>& input) : FuzzySearch(input) { ++live; }
+    ~CountedSearch() { --live; }
+};
+
+void testConcurrent()
+{
+    // Two alternating key sets; every answer must come from one of them
+    std::vector<uint32_t> evens, odds;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        evens.push_back(i * 2);
+        odds.push_back(i * 2 + 1);
+    }
+    FuzzySearch evenRef(evens), oddRef(odds);
+
+    bool allPassed = true;
+    {
+        ConcurrentFuzzySearch<CountedSearch> index(std::make_unique<CountedSearch>(evens));
+        std::atomic<bool> stop{false};
+        std::atomic<bool> readersPassed{true};
+
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&, t]() {
+                auto reader = index.RegisterReader();
+                std::mt19937 rng(t);
+                while (!stop.load(std::memory_order_relaxed)) {
+                    uint32_t q = rng() % 50000;
+                    auto r = reader.Find(q);
+                    if (r != evenRef.Find(q) && r != oddRef.Find(q)) {
+                        readersPassed = false;
+                    }
+                }
+            });
+        }
+
+        for (int i = 0; i < 2000; ++i) {
+            index.Publish(std::make_unique<CountedSearch>(i % 2 ? evens : odds));
+        }
+        stop = true;
+        for (auto& t : readers) {
+            t.join();
+        }
+
+        // With no reader left, everything but the current snapshot goes away
+        allPassed = readersPassed && index.Reclaim() == 0 && CountedSearch::live == 1;
+    }
+    allPassed = allPassed && CountedSearch::live == 0;
+
+    check(allPassed, "testConcurrent");
+}
+
+// ----------------------------------------------------
+// Test 10: Index files round-trip through mmap
+// ----------------------------------------------------
+void testMappedIndex()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "fuzzy_search_test.idx").string();
+    std::mt19937 rng{99};
+    bool allPassed = true;
+
+    for (IndexLayout layout : {IndexLayout::Sorted, IndexLayout::Eytzinger}) {
+        for (size_t n : {0, 1, 17, 100000}) {
+            std::vector<uint32_t> inputs(n);
+            for (auto& v : inputs) {
+                v = rng();
+            }
+            if (n > 2) {
+                inputs[0] = 0;
+                inputs[1] = MAX_VAL;
+            }
+
+            WriteFuzzyIndex(path, inputs, layout);
+            MappedFuzzySearch mapped(path);
+            FuzzySearch reference(inputs);
+            allPassed = allPassed && mapped.Size() == n && mapped.Layout() == layout;
+
+            std::vector<uint32_t> queries = {0, 1, 2, HALF_MAX, HALF_MAX + 1, MAX_VAL};
+            for (int i = 0; i < 2000; ++i) {
+                queries.push_back(rng());
+            }
+            std::vector<std::optional<uint32_t>> out(queries.size());
+            mapped.FindBatch(queries, out);
+            for (size_t i = 0; i < queries.size(); ++i) {
+                auto expected = reference.Find(queries[i]);
+                allPassed = allPassed && mapped.Find(queries[i]) == expected && out[i] == expected;
+            }
+        }
+    }
+
+    // A file that is not an index must be rejected, not served
+    {
+        std::ofstream junk(path, std::ios::binary | std::ios::trunc);
+        junk << std::string(128, 'x');
+    }
+    bool rejected = false;
+    try {
+        MappedFuzzySearch mapped(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    allPassed = allPassed && rejected;
+
+    // Nor an index whose key count disagrees with its payload, including a
+    // count of UINT64_MAX that count + 1 would wrap to a payload of 0
+    for (uint64_t count : {uint64_t{18}, std::numeric_limits<uint64_t>::max()}) {
+        WriteFuzzyIndex(path, std::vector<uint32_t>(17, 5), IndexLayout::Eytzinger);
+        IndexHeader header;
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        }
+        header.count = count;
+        header.payload_size = count == 18 ? 18 : 0;
+        {
+            std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+        rejected = false;
+        try {
+            MappedFuzzySearch mapped(path);
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        allPassed = allPassed && rejected;
+    }
+
+    std::filesystem::remove(path);
+    check(allPassed, "testMappedIndex");
+}
+
+// ----------------------------------------------------
+// Test 11: Compressed blocks decode back to the input
+// ----------------------------------------------------
+void testCompressedRoundTrip()
+{
+    std::mt19937 rng{5};
+    bool allPassed = true;
+
+    // Dense runs, duplicates, full 32-bit gaps and a partial last block
+    std::vector<std::vector<uint32_t>> datasets;
+    datasets.push_back(std::vector<uint32_t>(300, 7));
+    datasets.push_back({0, MAX_VAL});
+    std::vector<uint32_t> mixed;
+    for (int i = 0; i < 5000; ++i) {
+        mixed.push_back(i % 3 == 0 ? static_cast<uint32_t>(rng()) : static_cast<uint32_t>(rng() % 1000));
+    }
+    datasets.push_back(mixed);
+
+    for (auto data : datasets) {
+        std::sort(data.begin(), data.end());
+        CompressedLayout layout(data);
+        uint32_t block[CompressedLayout::kBlock];
+        for (size_t i = 0; i < data.size(); ++i) {
+            if (i % CompressedLayout::kBlock == 0) {
+                layout.DecodeBlock(i / CompressedLayout::kBlock, block);
+            }
+            allPassed = allPassed && block[i % CompressedLayout::kBlock] == data[i];
+        }
+    }
+
+    check(allPassed, "testCompressedRoundTrip");
+}
+
+// ----------------------------------------------------
+// Test 12: Radix sort and the in-place constructor
+// ----------------------------------------------------
+void testParallelRadixSort()
+{
+    std::mt19937 rng{12};
+    bool allPassed = true;
+
+    // Below and above the std::sort cutoff, uneven chunks, and keys whose
+    // upper bytes are all equal (skipped passes, result in the scratch buffer)
+    for (size_t n : {0, 1, 1000, 65536, 300001, 1000000}) {
+        for (uint32_t mask : {MAX_VAL, 0xFFFFFFu, 0xFFu}) {
+            std::vector<uint32_t> input(n);
+            for (auto& v : input) {
+                v = static_cast<uint32_t>(rng()) & mask;
+            }
+            std::vector<uint32_t> expected = input;
+            std::sort(expected.begin(), expected.end());
+
+            for (unsigned threads : {1u, 2u, 3u, 8u}) {
+                std::vector<uint32_t> keys = input;
+                ParallelRadixSort(keys, threads);
+                allPassed = allPassed && keys == expected;
+            }
+        }
+    }
+
+    std::vector<uint32_t> input(200000);
+    for (auto& v : input) {
+        v = static_cast<uint32_t>(rng());
+    }
+    FuzzySearch reference(input);
+    std::vector<uint32_t> copy1 = input;
+    std::vector<uint32_t> copy2 = input;
+    FuzzySearch moved(std::move(copy1));
+    FuzzySearch parallel(std::move(copy2), 4);
+    for (int i = 0; i < 10000; ++i) {
+        const uint32_t q = static_cast<uint32_t>(rng());
+        allPassed = allPassed && moved.Find(q) == reference.Find(q) && parallel.Find(q) == reference.Find(q);
+    }
+
+    check(allPassed, "testParallelRadixSort");
+}
+
+// ----------------------------------------------------
+// Test 13: FindAll / Count / FindNearest against a linear scan
+// ----------------------------------------------------
+template <typename Search>
+void testRangeQueries(const std::string& testName)
+{
+    std::mt19937 rng{13};
+    bool allPassed = true;
+
+    for (size_t n : {0, 1, 2, 100, 5000}) {
+        std::vector<uint32_t> inputs(n);
+        for (auto& v : inputs) {
+            // Small values repeat, big ones spread over the full range
+            v = rng() % 2 == 0 ? rng() % 200 : rng();
+        }
+        if (n > 2) {
+            inputs[0] = 0;
+            inputs[1] = MAX_VAL;
+        }
+        Search searcher(inputs);
+        std::vector<uint32_t> sorted = inputs;
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<uint32_t> queries = {0, 1, 2, 3, 100, HALF_MAX, HALF_MAX + 1, MAX_VAL - 1, MAX_VAL};
+        for (int i = 0; i < 300; ++i) {
+            queries.push_back(rng() % 400);
+            queries.push_back(rng());
+        }
+
+        for (auto q : queries) {
+            const uint64_t lower = (static_cast<uint64_t>(q) + 1) / 2;
+            const uint64_t upper = std::min<uint64_t>(static_cast<uint64_t>(q) * 2, MAX_VAL);
+
+            std::vector<uint32_t> expected;
+            std::optional<uint32_t> nearest;
+            for (auto v : sorted) {
+                if (v < lower || v > upper) {
+                    continue;
+                }
+                expected.push_back(v);
+                const uint64_t d = v > q ? v - q : q - v;
+                const uint64_t best = !nearest ? UINT64_MAX : (*nearest > q ? *nearest - q : q - *nearest);
+                if (d < best) {
+                    nearest = v; // ascending order keeps the smaller one on ties
+                }
+            }
+
+            const auto all = searcher.FindAll(q);
+            const bool inStorage = all.empty()
+                || (all.data() >= searcher.layout().Data().data()
+                    && all.data() + all.size() <= searcher.layout().Data().data() + n);
+            allPassed = allPassed && inStorage && std::equal(all.begin(), all.end(), expected.begin(), expected.end())
+                && searcher.Count(q) == expected.size() && searcher.FindNearest(q) == nearest;
+        }
+    }
+
+    check(allPassed, testName);
+}
+
+// ----------------------------------------------------
+// Main: run all tests
+// ----------------------------------------------------
+int main()
+{
+    testBasic();
+    testSingleElementArray();
+    testAllZeros();
+    testLargeValues();
+    testRandomData();
+    testFindBatch<FuzzySearch>("testFindBatch");
+
+    using EytzingerSearch = BasicFuzzySearch<EytzingerLayout>;
+    testAllZeros<EytzingerSearch>("testAllZeros/Eytzinger");
+    testLargeValues<EytzingerSearch>("testLargeValues/Eytzinger");
+    testMatchesReference<EytzingerSearch>("testMatchesReference/Eytzinger");
+    testFindBatch<EytzingerSearch>("testFindBatch/Eytzinger");
+
+    using STreeSearch = BasicFuzzySearch<STreeLayout>;
+    testAllZeros<STreeSearch>("testAllZeros/STree");
+    testLargeValues<STreeSearch>("testLargeValues/STree");
+    testMatchesReference<STreeSearch>("testMatchesReference/STree");
+    testFindBatch<STreeSearch>("testFindBatch/STree");
+
+    testAllZeros<DynamicFuzzySearch>("testAllZeros/BTree");
+    testLargeValues<DynamicFuzzySearch>("testLargeValues/BTree");
+    testMatchesReference<DynamicFuzzySearch>("testMatchesReference/BTree");
+    testFindBatch<DynamicFuzzySearch>("testFindBatch/BTree");
+    using CompressedSearch = BasicFuzzySearch<CompressedLayout>;
+    testAllZeros<CompressedSearch>("testAllZeros/Compressed");
+    testLargeValues<CompressedSearch>("testLargeValues/Compressed");
+    testMatchesReference<CompressedSearch>("testMatchesReference/Compressed");
+    testFindBatch<CompressedSearch>("testFindBatch/Compressed");
+    testCompressedRoundTrip();
+
+    using RadixSplineSearch = BasicFuzzySearch<RadixSplineLayout<>>;
+    testAllZeros<RadixSplineSearch>("testAllZeros/RadixSpline");
+    testLargeValues<RadixSplineSearch>("testLargeValues/RadixSpline");
+    testMatchesReference<RadixSplineSearch>("testMatchesReference/RadixSpline");
+    testFindBatch<RadixSplineSearch>("testFindBatch/RadixSpline");
+    // Tight corridor and a tiny radix table: many segments, frequent fallbacks
+    using TightSplineSearch = BasicFuzzySearch<RadixSplineLayout<1, 2>>;
+    testMatchesReference<TightSplineSearch>("testMatchesReference/RadixSpline<1,2>");
+    testFindBatch<TightSplineSearch>("testFindBatch/RadixSpline<1,2>");
+
+    testParallelRadixSort();
+    testRangeQueries<FuzzySearch>("testRangeQueries");
+    testRangeQueries<RadixSplineSearch>("testRangeQueries/RadixSpline");
+
+    testDynamic();
+    testConcurrent();
+    testMappedIndex();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include <benchmark/benchmark.h>
+
+#include "bench_data.h"
+#include "fuzzy_search.h"
+#include "eytzinger_layout.h"
+#include "s_tree_layout.h"
+#include "b_tree_layout.h"
+#include "compressed_layout.h"
+#include "radix_spline_layout.h"
+#include "radix_sort.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// Workload suite: the numbers every layout change is judged against.
+//
+// BM_Build     construction from an unsorted vector, args {keys, dist}
+// BM_Workload  Find over a query stream, args {keys, dist, hit%, zipf}
+//              (zipf is the exponent times 100; 0 is uniform)
+//
+// Reported: items_per_second (throughput of back-to-back Finds), p50_ns and
+// p99_ns (single Finds timed one by one, timer overhead subtracted),
+// bytes_per_key for layouts that report MemoryBytes(), and the hit ratio of
+// the stream actually generated.
+// -----------------------------------------------------------------------------
+
+// 4 KB (L1) .. 256 MB (DRAM) of keys
+static const std::vector<int> kSizes = {1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 26};
+
+static constexpr size_t kQueries = 1 << 16;
+static constexpr size_t kLatencySamples = 1 << 14;
+
+// Consecutive workloads mostly share a size and distribution; keep the last
+// sorted key set around instead of regenerating it for each one.
+static const std::vector<uint32_t>& SortedDataset(size_t n, KeyDistribution dist)
+{
+    static KeyDistribution cached_dist = KeyDistribution::Uniform;
+    static std::vector<uint32_t> cached;
+    if (cached.size() != n || cached_dist != dist) {
+        cached = DistributedKeys(n, dist, 42);
+        ParallelRadixSort(cached, std::max(1u, std::thread::hardware_concurrency()));
+        cached_dist = dist;
+    }
+    return cached;
+}
+
+// Cost of an empty steady_clock::now() pair, taken off each latency sample
+static double TimerOverheadNs()
+{
+    static const double overhead = []() {
+        std::vector<double> samples(10000);
+        for (auto& s : samples) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto t1 = std::chrono::steady_clock::now();
+            s = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }();
+    return overhead;
+}
+
+template <typename Search>
+static void ReportLatency(benchmark::State& state, const Search& searcher, const std::vector<uint32_t>& queries)
+{
+    const double overhead = TimerOverheadNs();
+    std::vector<double> samples(kLatencySamples);
+    for (size_t i = 0; i < kLatencySamples; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(searcher.Find(queries[i % queries.size()]));
+        const auto t1 = std::chrono::steady_clock::now();
+        samples[i] = std::max(0.0, std::chrono::duration<double, std::nano>(t1 - t0).count() - overhead);
+    }
+
+    auto percentile = [&samples](double p) {
+        auto nth = samples.begin() + static_cast<ptrdiff_t>(p * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p99_ns"] = percentile(0.99);
+}
+
+template <typename Search>
+static void ReportBytesPerKey(benchmark::State& state, const Search& searcher, size_t n)
+{
+    if constexpr (requires { searcher.layout().MemoryBytes(); }) {
+        state.counters["bytes_per_key"] = static_cast<double>(searcher.layout().MemoryBytes()) / static_cast<double>(n);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// BENCHMARKS
+// -----------------------------------------------------------------------------
+
+template <typename Layout>
+static void BM_Build(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto dist = static_cast<KeyDistribution>(state.range(1));
+    const std::vector<uint32_t> keys = DistributedKeys(n, dist, 42);
+
+    std::optional<BasicFuzzySearch<Layout>> searcher;
+    for (auto _ : state) {
+        state.PauseTiming();
+        searcher.reset(); // destruction is not part of the build
+        std::vector<uint32_t> input = keys;
+        state.ResumeTiming();
+        searcher.emplace(std::move(input));
+        benchmark::DoNotOptimize(*searcher);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    ReportBytesPerKey(state, *searcher, n);
+}
+
+template <typename Layout>
+static void BM_Workload(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const auto dist = static_cast<KeyDistribution>(state.range(1));
+    const int hit_percent = static_cast<int>(state.range(2));
+    const double zipf = static_cast<double>(state.range(3)) / 100.0;
+
+    const std::vector<uint32_t>& sorted = SortedDataset(n, dist);
+    const BasicFuzzySearch<Layout> searcher{Layout(sorted)};
+    const std::vector<uint32_t> queries = MakeQueries(sorted, kQueries, hit_percent, zipf, 7);
+
+    size_t idx = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(searcher.Find(queries[idx]));
+        idx = (idx + 1) % kQueries;
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    size_t hits = 0;
+    for (auto q : queries) {
+        hits += searcher.Find(q).has_value();
+    }
+    state.counters["hit_ratio"] = static_cast<double>(hits) / static_cast<double>(kQueries);
+    ReportLatency(state, searcher, queries);
+    ReportBytesPerKey(state, searcher, n);
+}
+
+static void BuildArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"keys", "dist"});
+    for (int n : kSizes) {
+        for (auto dist : {KeyDistribution::Uniform, KeyDistribution::Lognormal, KeyDistribution::Clustered}) {
+            b->Args({n, static_cast<int>(dist)});
+        }
+    }
+}
+
+// One axis at a time around the baseline (uniform keys, all hits, uniform
+// query popularity), so the suite stays small enough to run on every change.
+static void WorkloadArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"keys", "dist", "hit%", "zipf"});
+    const int uniform = static_cast<int>(KeyDistribution::Uniform);
+    for (int n : kSizes) {
+        for (auto dist : {KeyDistribution::Uniform, KeyDistribution::Lognormal, KeyDistribution::Clustered}) {
+            b->Args({n, static_cast<int>(dist), 100, 0});
+        }
+        b->Args({n, uniform, 50, 0});
+        b->Args({n, uniform, 0, 0});
+        b->Args({n, uniform, 100, 99});
+        b->Args({n, uniform, 100, 120});
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_Build, SortedLayout)->Apply(BuildArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Build, EytzingerLayout)->Apply(BuildArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Build, STreeLayout)->Apply(BuildArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Build, BTreeLayout)->Apply(BuildArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Build, CompressedLayout)->Apply(BuildArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Build, RadixSplineLayout<>)->Apply(BuildArgs)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_Workload, SortedLayout)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Workload, EytzingerLayout)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Workload, STreeLayout)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Workload, BTreeLayout)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Workload, CompressedLayout)->Apply(WorkloadArgs);
+BENCHMARK_TEMPLATE(BM_Workload, RadixSplineLayout<>)->Apply(WorkloadArgs);
+
+BENCHMARK_MAIN();
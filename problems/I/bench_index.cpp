@@ -0,0 +1,133 @@
+#include "block_index.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// g++ -O2 -std=c++17 bench_index.cpp -o bench_index && ./bench_index
+//
+// Lookup phase only (no I/O): the same random queries answered by
+//   main.cpp        std::lower_bound over prefix, then st[]
+//   main_templ.cpp  hand-written binary search over prefix, then blockStart[]
+//   BlockIndex      Kth, one query at a time
+//   BlockIndex      KthBatch, 16 queries in lockstep
+// at k = 10^5 (index fits in L2) and k = 10^7 (it does not).
+
+static constexpr long long kN = 1000000000000000000LL;
+static constexpr size_t kQueries = 1 << 22;
+
+struct Blocks {
+    vector<long long> blockStart;
+    vector<long long> prefix;
+};
+
+// The arrays both current solvers build
+static Blocks buildBlocks(long long n, const vector<long long>& deleted)
+{
+    const int k = static_cast<int>(deleted.size());
+    Blocks b;
+    b.blockStart.resize(k + 1);
+    b.prefix.resize(k + 1);
+    long long total = 0;
+    for (int i = 0; i <= k; i++) {
+        const long long start = (i == 0 ? 1 : deleted[i - 1] + 1);
+        const long long end = (i == k ? n : deleted[i] - 1);
+        b.blockStart[i] = start;
+        total += max(0LL, end - start + 1);
+        b.prefix[i] = total;
+    }
+    return b;
+}
+
+static long long solveLowerBound(const Blocks& b, long long p)
+{
+    if (p > b.prefix.back()) {
+        return -1;
+    }
+    const int idx = static_cast<int>(lower_bound(b.prefix.begin(), b.prefix.end(), p) - b.prefix.begin());
+    const long long before = (idx == 0 ? 0LL : b.prefix[idx - 1]);
+    return b.blockStart[idx] + (p - before) - 1;
+}
+
+static long long solveTempl(const Blocks& b, long long p)
+{
+    const int k = static_cast<int>(b.prefix.size()) - 1;
+    if (p > b.prefix[k]) {
+        return -1;
+    }
+    int low = 0, high = k;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (b.prefix[mid] >= p) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    const long long before = (low == 0 ? 0LL : b.prefix[low - 1]);
+    return b.blockStart[low] + (p - before) - 1;
+}
+
+template <typename Solve>
+static void run(const char* name, const vector<long long>& queries, vector<long long>& answers, Solve solve)
+{
+    const auto t0 = chrono::steady_clock::now();
+    solve(queries, answers);
+    const auto t1 = chrono::steady_clock::now();
+    const double ns = chrono::duration<double, nano>(t1 - t0).count() / static_cast<double>(queries.size());
+
+    long long checksum = 0;
+    for (long long a : answers) {
+        checksum = checksum * 31 + a;
+    }
+    printf("  %-22s %8.1f ns/query   checksum %016llx\n", name, ns, static_cast<unsigned long long>(checksum));
+}
+
+int main()
+{
+    for (long long k : {100000LL, 10000000LL}) {
+        mt19937_64 rng(k);
+        // Deleted numbers spread over [1, 1000k]: blocks of all lengths
+        vector<long long> deleted(k);
+        for (auto& d : deleted) {
+            d = static_cast<long long>(rng() % static_cast<unsigned long long>(1000 * k)) + 1;
+        }
+        sort(deleted.begin(), deleted.end());
+        deleted.erase(unique(deleted.begin(), deleted.end()), deleted.end());
+
+        const Blocks blocks = buildBlocks(kN, deleted);
+        const BlockIndex index(kN, deleted);
+
+        // Mostly p inside the deleted range, where the search actually works
+        vector<long long> queries(kQueries);
+        for (auto& p : queries) {
+            p = static_cast<long long>(rng() % static_cast<unsigned long long>(1000 * k)) + 1;
+        }
+        vector<long long> answers(kQueries);
+
+        printf("k = %zu: prefix arrays %zu MB, BlockIndex %zu MB\n", deleted.size(),
+               (blocks.prefix.size() * 2 * sizeof(long long)) >> 20, index.MemoryBytes() >> 20);
+        run("main.cpp lower_bound", queries, answers, [&](const auto& qs, auto& out) {
+            for (size_t i = 0; i < qs.size(); i++) {
+                out[i] = solveLowerBound(blocks, qs[i]);
+            }
+        });
+        run("main_templ.cpp search", queries, answers, [&](const auto& qs, auto& out) {
+            for (size_t i = 0; i < qs.size(); i++) {
+                out[i] = solveTempl(blocks, qs[i]);
+            }
+        });
+        run("BlockIndex::Kth", queries, answers, [&](const auto& qs, auto& out) {
+            for (size_t i = 0; i < qs.size(); i++) {
+                out[i] = index.Kth(qs[i]);
+            }
+        });
+        run("BlockIndex::KthBatch", queries, answers,
+            [&](const auto& qs, auto& out) { index.KthBatch(qs.data(), out.data(), qs.size()); });
+    }
+    return 0;
+}
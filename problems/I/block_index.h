@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// ----------------------------------------------------
+// Packed block index: one key per deleted number
+// ----------------------------------------------------
+//
+// The blocks of main_templ.cpp do not need to be stored at all. With the
+// deleted numbers d_0 < d_1 < ... < d_{k-1}, exactly d_i - i - 1 remaining
+// numbers lie below d_i. If j of those counts are < p, the first j deleted
+// numbers are below the p-th remaining one and the others above it, so
+//
+//     answer = p + j,   j = #{ i : d_i - i - 1 < p }
+//
+// which is a single lower_bound over one array of k keys (8 bytes each, no
+// parallel start/prefix arrays).
+//
+// The keys are laid out in Eytzinger (BFS) order and padded with +inf up to
+// a perfect tree of 2^H - 1 nodes (at most twice k). That buys two things:
+// every search takes exactly H branchless steps, and the leaf slot it ends
+// in, i - 2^H, is j itself; no rank lookup or trailing-bit fix-up. The
+// eight great-grandchildren of node i share one cache line, so each step
+// prefetches three levels ahead.
+class BlockIndex
+{
+public:
+    // `deleted` sorted ascending, without duplicates, all in [1, n].
+    BlockIndex(long long n, const std::vector<long long>& deleted)
+        : remaining_(n - static_cast<long long>(deleted.size()))
+    {
+        while ((size_t{1} << height_) - 1 < deleted.size()) {
+            height_++;
+        }
+        const size_t nodes = (size_t{1} << height_) - 1;
+
+        // Slot 0 is unused; over-allocate so slot 0 can sit on a line boundary
+        storage_.resize(nodes + 1 + kBlock);
+        const auto addr = reinterpret_cast<uintptr_t>(storage_.data());
+        tree_ = storage_.data() + (kLineBytes - addr % kLineBytes) % kLineBytes / sizeof(long long);
+
+        size_t next = 0;
+        Build(deleted, next, 1);
+    }
+
+    // tree_ points into storage_: a move keeps the buffer, a copy would not
+    BlockIndex(const BlockIndex&) = delete;
+    BlockIndex& operator=(const BlockIndex&) = delete;
+    BlockIndex(BlockIndex&&) = default;
+    BlockIndex& operator=(BlockIndex&&) = default;
+
+    // The p-th remaining number, or -1 if fewer than p remain. Matches the
+    // prefix-array solvers for every p, including p < 1.
+    long long Kth(long long p) const
+    {
+        if (p > remaining_) {
+            return -1;
+        }
+        size_t i = 1;
+        for (unsigned level = 0; level < height_; level++) {
+            Prefetch(i * kBlock);
+            i = 2 * i + (tree_[i] < p);
+        }
+        return p + static_cast<long long>(i - (size_t{1} << height_));
+    }
+
+    // Kth for count queries at once. The searches advance in lockstep,
+    // kLanes at a time, so their cache misses overlap.
+    void KthBatch(const long long* p, long long* out, size_t count) const
+    {
+        for (size_t first = 0; first < count; first += kLanes) {
+            const size_t lanes = std::min(kLanes, count - first);
+            size_t i[kLanes];
+            std::fill(i, i + lanes, size_t{1});
+
+            for (unsigned level = 0; level < height_; level++) {
+                for (size_t j = 0; j < lanes; j++) {
+                    Prefetch(i[j] * kBlock);
+                    i[j] = 2 * i[j] + (tree_[i[j]] < p[first + j]);
+                }
+            }
+            for (size_t j = 0; j < lanes; j++) {
+                const long long q = p[first + j];
+                out[first + j] = q > remaining_ ? -1 : q + static_cast<long long>(i[j] - (size_t{1} << height_));
+            }
+        }
+    }
+
+    size_t MemoryBytes() const { return storage_.size() * sizeof(long long); }
+
+private:
+    static constexpr size_t kLineBytes = 64;
+    static constexpr size_t kBlock = kLineBytes / sizeof(long long);
+    static constexpr size_t kLanes = 16;
+
+    // In-order walk of the implicit tree; slots past the keys become +inf
+    void Build(const std::vector<long long>& deleted, size_t& next, size_t node)
+    {
+        if (node >= (size_t{1} << height_)) {
+            return;
+        }
+        Build(deleted, next, 2 * node);
+        if (next < deleted.size()) {
+            tree_[node] = deleted[next] - static_cast<long long>(next) - 1;
+        } else {
+            tree_[node] = std::numeric_limits<long long>::max();
+        }
+        next++;
+        Build(deleted, next, 2 * node + 1);
+    }
+
+    void Prefetch(size_t index) const
+    {
+        // Near the leaves the index runs past the array; prefetches never
+        // fault, so only keep the pointer arithmetic out of the language's hands.
+        const auto addr = reinterpret_cast<uintptr_t>(tree_) + index * sizeof(long long);
+        __builtin_prefetch(reinterpret_cast<const void*>(addr));
+    }
+
+    long long remaining_;
+    unsigned height_ = 0;
+    std::vector<long long> storage_;
+    long long* tree_ = nullptr;
+};
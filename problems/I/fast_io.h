@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ----------------------------------------------------
+// Fast integer input
+// ----------------------------------------------------
+//
+// If stdin is a regular file it is mapped in one go; otherwise (pipe,
+// terminal) it is read in 1 MB chunks. Integers are parsed by hand, eight
+// digits at a time where the buffer allows it (SWAR: one 64-bit load, a
+// digit check and three multiplies instead of eight multiply-adds).
+class FastInput
+{
+public:
+    explicit FastInput(int fd = STDIN_FILENO)
+        : fd_(fd)
+    {
+        struct stat st;
+        if (::fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (addr != MAP_FAILED) {
+                ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+                map_ = addr;
+                map_size_ = static_cast<size_t>(st.st_size);
+                p_ = static_cast<const char*>(addr);
+                end_ = p_ + map_size_;
+                eof_ = true;
+                return;
+            }
+        }
+        buf_.resize(kChunk);
+        p_ = end_ = buf_.data();
+    }
+
+    FastInput(const FastInput&) = delete;
+    FastInput& operator=(const FastInput&) = delete;
+
+    ~FastInput()
+    {
+        if (map_ != nullptr) {
+            ::munmap(map_, map_size_);
+        }
+    }
+
+    // Reads the next integer; false at end of input (out is left alone).
+    template <typename Int>
+    bool Read(Int& out)
+    {
+        static_assert(std::is_integral_v<Int>);
+
+        // Skip whitespace, refilling as needed
+        for (;;) {
+            while (p_ < end_ && static_cast<unsigned char>(*p_) <= ' ') {
+                ++p_;
+            }
+            if (p_ < end_) {
+                break;
+            }
+            if (!Refill()) {
+                return false;
+            }
+        }
+        // Make sure the whole token is in the buffer
+        if (end_ - p_ < kMaxToken) {
+            Refill();
+        }
+
+        bool negative = false;
+        if (*p_ == '-') {
+            negative = true;
+            ++p_;
+        }
+
+        uint64_t value = 0;
+        while (end_ - p_ >= 8) {
+            uint64_t chunk;
+            std::memcpy(&chunk, p_, 8);
+            if (!AllDigits(chunk)) {
+                break;
+            }
+            value = value * 100000000 + ParseEight(chunk);
+            p_ += 8;
+        }
+        while (p_ < end_ && static_cast<unsigned>(*p_ - '0') < 10) {
+            value = value * 10 + static_cast<unsigned>(*p_ - '0');
+            ++p_;
+        }
+
+        out = static_cast<Int>(negative ? 0 - value : value);
+        return true;
+    }
+
+private:
+    static constexpr size_t kChunk = 1 << 20;
+    // Longest token we parse: sign + 20 digits
+    static constexpr ptrdiff_t kMaxToken = 32;
+
+    // Moves the unread tail to the front and reads more behind it.
+    bool Refill()
+    {
+        if (eof_) {
+            return p_ < end_;
+        }
+        const size_t left = static_cast<size_t>(end_ - p_);
+        std::memmove(buf_.data(), p_, left);
+        p_ = buf_.data();
+        end_ = p_ + left;
+
+        while (end_ < buf_.data() + buf_.size()) {
+            const ssize_t got = ::read(fd_, buf_.data() + (end_ - p_), buf_.size() - (end_ - p_));
+            if (got > 0) {
+                end_ += got;
+                if (end_ - p_ >= kMaxToken) {
+                    break;
+                }
+            } else if (got == 0 || errno != EINTR) {
+                eof_ = true;
+                break;
+            }
+        }
+        return p_ < end_;
+    }
+
+    // Eight ASCII digits, first one in the lowest byte (little endian)
+    static bool AllDigits(uint64_t chunk)
+    {
+        return ((chunk & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull)
+            && (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull);
+    }
+
+    static uint32_t ParseEight(uint64_t chunk)
+    {
+        chunk -= 0x3030303030303030ull;
+        // Pairs of digits, then groups of four, then all eight
+        chunk = (chunk * 10) + (chunk >> 8);
+        chunk = (((chunk & 0x000000FF000000FFull) * (100 + (1000000ull << 32)))
+                 + (((chunk >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32))))
+              >> 32;
+        return static_cast<uint32_t>(chunk);
+    }
+
+    int fd_;
+    void* map_ = nullptr;
+    size_t map_size_ = 0;
+    std::vector<char> buf_;
+    const char* p_ = nullptr;
+    const char* end_ = nullptr;
+    bool eof_ = false;
+};
+
+// ----------------------------------------------------
+// Buffered output
+// ----------------------------------------------------
+//
+// Collects output in a 1 MB buffer and hands it to write() when full and on
+// destruction; nothing is flushed per line.
+class FastOutput
+{
+public:
+    explicit FastOutput(int fd = STDOUT_FILENO)
+        : fd_(fd)
+        , buf_(kSize)
+    {
+    }
+
+    FastOutput(const FastOutput&) = delete;
+    FastOutput& operator=(const FastOutput&) = delete;
+
+    ~FastOutput() { Flush(); }
+
+    template <typename Int>
+    void Write(Int value)
+    {
+        static_assert(std::is_integral_v<Int>);
+        if (buf_.size() - len_ < kMaxToken) {
+            Flush();
+        }
+
+        uint64_t magnitude = static_cast<uint64_t>(value);
+        if constexpr (std::is_signed_v<Int>) {
+            if (value < 0) {
+                buf_[len_++] = '-';
+                magnitude = 0 - magnitude;
+            }
+        }
+
+        // Digits come out backwards; build them at the end of a scratch
+        // area and copy once
+        char digits[kMaxToken];
+        char* it = digits + kMaxToken;
+        while (magnitude >= 100) {
+            const uint64_t rest = magnitude / 100;
+            it -= 2;
+            std::memcpy(it, kPairs + 2 * (magnitude - rest * 100), 2);
+            magnitude = rest;
+        }
+        if (magnitude >= 10) {
+            it -= 2;
+            std::memcpy(it, kPairs + 2 * magnitude, 2);
+        } else {
+            *--it = static_cast<char>('0' + magnitude);
+        }
+
+        const size_t count = static_cast<size_t>(digits + kMaxToken - it);
+        std::memcpy(buf_.data() + len_, it, count);
+        len_ += count;
+    }
+
+    void Write(char c)
+    {
+        if (len_ == buf_.size()) {
+            Flush();
+        }
+        buf_[len_++] = c;
+    }
+
+    void Flush()
+    {
+        size_t done = 0;
+        while (done < len_) {
+            const ssize_t put = ::write(fd_, buf_.data() + done, len_ - done);
+            if (put > 0) {
+                done += static_cast<size_t>(put);
+            } else if (put < 0 && errno != EINTR) {
+                break; // nowhere to report it; drop the rest
+            }
+        }
+        len_ = 0;
+    }
+
+private:
+    static constexpr size_t kSize = 1 << 20;
+    static constexpr size_t kMaxToken = 24;
+    static constexpr char kPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    int fd_;
+    std::vector<char> buf_;
+    size_t len_ = 0;
+};
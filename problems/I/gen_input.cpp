@@ -0,0 +1,143 @@
+#include "fast_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// g++ -O2 -std=c++17 gen_input.cpp -o gen_input
+//
+// Usage: gen_input --k K --q Q [--pattern P] [--seed S] > input.txt
+//
+// Writes a problem input with n = 10^18, K distinct deleted numbers and Q
+// queries. Patterns:
+//
+//   sparse     deletions spread uniformly over [1, n]: k + 1 huge blocks
+//   clustered  deletions in runs of consecutive numbers around a few
+//              hundred centres: most blocks are empty
+//   prefix     1 .. K deleted: every block but the last is empty and
+//              every answer is shifted by K
+//
+// Queries are mixed to hit the awkward spots: 7/16 uniform over the
+// remaining numbers, 7/16 right at block boundaries (p = d_i - i - 1 and
+// its neighbours), the rest at the edges (1, the last remaining number and
+// just past it, plus 0 and n).
+
+static constexpr long long kN = 1000000000000000000LL;
+
+static vector<long long> makeDeleted(long long k, const string& pattern, mt19937_64& rng)
+{
+    vector<long long> deleted;
+    deleted.reserve(k);
+    if (pattern == "prefix") {
+        for (long long i = 1; i <= k; i++) {
+            deleted.push_back(i);
+        }
+        return deleted;
+    }
+
+    if (pattern == "sparse") {
+        uniform_int_distribution<long long> pick(1, kN);
+        while (static_cast<long long>(deleted.size()) < k) {
+            deleted.push_back(pick(rng));
+        }
+    } else {
+        // Runs of 1..64 consecutive numbers near 256 centres, with small
+        // gaps between the runs of one cluster
+        uniform_int_distribution<long long> centre(1, kN / 2);
+        vector<long long> next(256);
+        for (auto& c : next) {
+            c = centre(rng);
+        }
+        uniform_int_distribution<int> cluster(0, static_cast<int>(next.size()) - 1);
+        uniform_int_distribution<int> run(1, 64);
+        uniform_int_distribution<int> gap(1, 16);
+        while (static_cast<long long>(deleted.size()) < k) {
+            long long& at = next[cluster(rng)];
+            for (int r = run(rng); r > 0 && static_cast<long long>(deleted.size()) < k; r--) {
+                deleted.push_back(at++);
+            }
+            at += gap(rng);
+        }
+    }
+
+    // Top up whatever the duplicates cost until there are k distinct ones
+    uniform_int_distribution<long long> pick(1, kN);
+    for (;;) {
+        sort(deleted.begin(), deleted.end());
+        deleted.erase(unique(deleted.begin(), deleted.end()), deleted.end());
+        if (static_cast<long long>(deleted.size()) >= k) {
+            break;
+        }
+        while (static_cast<long long>(deleted.size()) < k) {
+            deleted.push_back(pick(rng));
+        }
+    }
+    return deleted;
+}
+
+int main(int argc, char** argv) {
+    long long k = -1;
+    long long q = -1;
+    string pattern = "sparse";
+    unsigned long long seed = 1;
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--k") == 0 && hasValue) {
+            k = stoll(argv[++i]);
+        } else if (strcmp(argv[i], "--q") == 0 && hasValue) {
+            q = stoll(argv[++i]);
+        } else if (strcmp(argv[i], "--pattern") == 0 && hasValue) {
+            pattern = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = stoull(argv[++i]);
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok || k < 1 || q < 0 || (pattern != "sparse" && pattern != "clustered" && pattern != "prefix")) {
+        cerr << "usage: " << argv[0] << " --k K --q Q [--pattern sparse|clustered|prefix] [--seed S]\n";
+        return 2;
+    }
+
+    mt19937_64 rng(seed);
+    const vector<long long> deleted = makeDeleted(k, pattern, rng);
+    const long long remaining = kN - k;
+
+    FastOutput out;
+    out.Write(kN);
+    out.Write(' ');
+    out.Write(k);
+    out.Write('\n');
+    for (long long i = 0; i < k; i++) {
+        out.Write(deleted[i]);
+        out.Write(i + 1 < k ? ' ' : '\n');
+    }
+    out.Write(q);
+    out.Write('\n');
+
+    uniform_int_distribution<long long> uniform(1, remaining);
+    uniform_int_distribution<long long> block(0, k - 1);
+    uniform_int_distribution<int> nudge(-1, 1);
+    const long long edges[] = {1, remaining, remaining + 1, 0, kN, 2};
+    for (long long i = 0; i < q; i++) {
+        long long p;
+        const unsigned kind = rng() % 16;
+        if (kind < 7) {
+            p = uniform(rng);
+        } else if (kind < 14) {
+            const long long j = block(rng);
+            p = max(1LL, deleted[j] - j - 1 + nudge(rng));
+        } else {
+            p = edges[rng() % size(edges)];
+        }
+        out.Write(p);
+        out.Write('\n');
+    }
+    return 0;
+}
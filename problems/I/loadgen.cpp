@@ -0,0 +1,210 @@
+#include "query_protocol.h"
+#include "remaining_solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// g++ -O2 -std=c++17 loadgen.cpp -o loadgen -pthread
+//
+// Usage: loadgen <socket-path> [--connections C] [--batch B] [--depth D]
+//                [--requests R] [--max-p P] [--check deleted-set]
+//
+// Opens C connections to a running server, each sending R requests of B
+// random p in [1, P] and keeping up to D of them in flight (D = 1 is plain
+// request/response, more is pipelining). Reports queries/s and the latency
+// of a request, from the moment it was written until its response was read
+// completely.
+//
+// Answers are only checked with --check, given the file the server loaded:
+// every answer is then compared with a local RemainingSolver after its
+// response is timed, and any mismatch fails the run. Without it loadgen
+// measures load only.
+//
+// Keep D * B * 8 bytes well under the socket buffer (a few hundred KB);
+// the generator only reads once its window is full.
+
+using Clock = chrono::steady_clock;
+
+struct Options {
+    string path;
+    int connections = 4;
+    uint32_t batch = 64;
+    int depth = 8;
+    int requests = 20000;
+    long long maxP = 1000000000LL;
+    string checkPath;
+};
+
+struct ConnectionResult {
+    vector<double> latencies; // per request in ns, empty if the connection failed
+    long long mismatches = 0; // answers that differ from the local solver
+};
+
+// check may be null: answers are then read but not compared
+static ConnectionResult runConnection(const Options& opt, const sockaddr_un& addr, unsigned seed,
+                                      const RemainingSolver* check)
+{
+    ConnectionResult result;
+    vector<double>& latencies = result.latencies;
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+        cerr << "loadgen: connect: " << strerror(errno) << "\n";
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        return result;
+    }
+
+    mt19937_64 rng(seed);
+    uniform_int_distribution<long long> pick(1, opt.maxP);
+    vector<char> request(sizeof(uint32_t) + opt.batch * sizeof(long long));
+    vector<long long> response(opt.batch);
+    memcpy(request.data(), &opt.batch, sizeof(uint32_t));
+    // Responses come back in order, so request r's queries stay in slot
+    // r % D until its response has been read
+    vector<long long> sentQueries(check != nullptr ? static_cast<size_t>(opt.depth) * opt.batch : 0);
+    vector<long long> expected(check != nullptr ? opt.batch : 0);
+
+    deque<Clock::time_point> inFlight;
+    latencies.reserve(opt.requests);
+    int sent = 0;
+    while (static_cast<int>(latencies.size()) < opt.requests) {
+        if (sent < opt.requests && static_cast<int>(inFlight.size()) < opt.depth) {
+            for (uint32_t i = 0; i < opt.batch; i++) {
+                const long long p = pick(rng);
+                memcpy(request.data() + sizeof(uint32_t) + i * sizeof(long long), &p, sizeof(p));
+                if (check != nullptr) {
+                    sentQueries[static_cast<size_t>(sent % opt.depth) * opt.batch + i] = p;
+                }
+            }
+            inFlight.push_back(Clock::now());
+            if (!WriteFull(fd, request.data(), request.size())) {
+                break;
+            }
+            sent++;
+            continue;
+        }
+        if (!ReadFull(fd, response.data(), response.size() * sizeof(long long))) {
+            break;
+        }
+        latencies.push_back(chrono::duration<double, nano>(Clock::now() - inFlight.front()).count());
+        inFlight.pop_front();
+        if (check != nullptr) {
+            const long long* queries =
+                sentQueries.data() + static_cast<size_t>((latencies.size() - 1) % opt.depth) * opt.batch;
+            check->AnswerBatch(queries, expected.data(), opt.batch);
+            for (uint32_t i = 0; i < opt.batch; i++) {
+                if (response[i] != expected[i] && result.mismatches++ == 0) {
+                    cerr << "loadgen: p = " << queries[i] << " answered " << response[i] << ", expected "
+                         << expected[i] << "\n";
+                }
+            }
+        }
+    }
+    if (static_cast<int>(latencies.size()) < opt.requests) {
+        cerr << "loadgen: connection closed after " << latencies.size() << " responses\n";
+    }
+    ::close(fd);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--connections") == 0 && hasValue) {
+            opt.connections = max(1, stoi(argv[++i]));
+        } else if (strcmp(argv[i], "--batch") == 0 && hasValue) {
+            opt.batch = static_cast<uint32_t>(clamp(stoll(argv[++i]), 1LL, static_cast<long long>(kMaxBatch)));
+        } else if (strcmp(argv[i], "--depth") == 0 && hasValue) {
+            opt.depth = max(1, stoi(argv[++i]));
+        } else if (strcmp(argv[i], "--requests") == 0 && hasValue) {
+            opt.requests = max(1, stoi(argv[++i]));
+        } else if (strcmp(argv[i], "--max-p") == 0 && hasValue) {
+            opt.maxP = max(1LL, stoll(argv[++i]));
+        } else if (strcmp(argv[i], "--check") == 0 && hasValue) {
+            opt.checkPath = argv[++i];
+        } else if (opt.path.empty() && argv[i][0] != '-') {
+            opt.path = argv[i];
+        } else {
+            ok = false;
+        }
+    }
+    sockaddr_un addr;
+    if (!ok || opt.path.empty() || !MakeAddress(opt.path, addr)) {
+        cerr << "usage: " << argv[0]
+             << " <socket-path> [--connections C] [--batch B] [--depth D] [--requests R] [--max-p P]"
+                " [--check deleted-set]\n";
+        return 2;
+    }
+
+    optional<RemainingSolver> check;
+    if (!opt.checkPath.empty()) {
+        const int fd = ::open(opt.checkPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            cerr << "loadgen: cannot open " << opt.checkPath << ": " << strerror(errno) << "\n";
+            return 2;
+        }
+        {
+            FastInput in(fd);
+            check.emplace(RemainingSolver::Load(in));
+        }
+        ::close(fd);
+    }
+
+    vector<ConnectionResult> perConnection(opt.connections);
+    const auto t0 = Clock::now();
+    {
+        vector<thread> clients;
+        for (int c = 0; c < opt.connections; c++) {
+            clients.emplace_back([&, c] { perConnection[c] = runConnection(opt, addr, 1000 + c, check ? &*check : nullptr); });
+        }
+        for (auto& t : clients) {
+            t.join();
+        }
+    }
+    const double seconds = chrono::duration<double>(Clock::now() - t0).count();
+
+    vector<double> latencies;
+    long long mismatches = 0;
+    for (auto& r : perConnection) {
+        latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+        mismatches += r.mismatches;
+    }
+    if (latencies.empty()) {
+        cerr << "loadgen: no responses\n";
+        return 1;
+    }
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))] / 1000.0;
+    };
+
+    const double requests = static_cast<double>(latencies.size());
+    printf("connections %d, batch %u, depth %d: %.0f requests in %.2f s\n", opt.connections, opt.batch, opt.depth,
+           requests, seconds);
+    printf("throughput  %.0f requests/s, %.0f queries/s\n", requests / seconds, requests * opt.batch / seconds);
+    printf("latency us  p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n", percentile(0.50), percentile(0.90),
+           percentile(0.99), percentile(0.999), latencies.back() / 1000.0);
+    if (check) {
+        printf("checked     %.0f answers, %lld wrong\n", requests * opt.batch, mismatches);
+    }
+    return static_cast<int>(latencies.size()) == opt.connections * opt.requests && mismatches == 0 ? 0 : 1;
+}
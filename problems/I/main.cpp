@@ -1,13 +1,19 @@
-#include <iostream>
+#include "fast_io.h"
+
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 
 
 using namespace std;
 
 int main() {
-    int64_t n; int k; cin >> n >> k;
+    FastInput in;
+    FastOutput out;
+
+    int64_t n = 0; int k = 0; in.Read(n); in.Read(k);
     vector<int64_t> d(k);
-    for(int i = 0; i < k; i++) cin >> d[i];
+    for(int i = 0; i < k; i++) in.Read(d[i]);
 
     vector<int64_t> st(k+1), en(k+1), le(k+1, 0LL);
 
@@ -27,18 +33,18 @@ int main() {
     prefix[0] = le[0];
     for(int i = 1; i <= k; i++) prefix[i] = prefix[i - 1] + le[i];
 
-    int q; cin >> q;
+    int q = 0; in.Read(q);
     while(q--) {
-        int64_t p; cin >> p;
+        int64_t p = 0; in.Read(p);
         if(p > prefix[k]) {
-            cout << -1 << std::endl;
+            out.Write(-1); out.Write('\n');
             continue;
         }
         auto it = std::lower_bound(prefix.begin(), prefix.end(), p);
         int idx = static_cast<int>(it - prefix.begin());
 
         int64_t before = (idx == 0 ? 0LL : prefix[idx - 1]);
-        cout << (st[idx] + (p - before) - 1) << std::endl;
+        out.Write(st[idx] + (p - before) - 1); out.Write('\n');
     }
     return 0;
 }
\ No newline at end of file
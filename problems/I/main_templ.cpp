@@ -1,6 +1,16 @@
+#include "block_index.h"
+#include "fast_io.h"
+#include "remaining_numbers.h"
+
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
 
 using namespace std;
 
@@ -61,19 +71,175 @@ int main() {
 }
 */
 
-int main() {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
+// ----------------------------------------------------
+// Offline batch mode
+// ----------------------------------------------------
+//
+// With many queries, one full binary search each wastes most of its steps
+// on cache misses over the same prefix array. The batch mode reads all
+// queries first and answers them through a radix table over prefix:
+// bucket b covers p in [b * 2^shift + 1, (b + 1) * 2^shift], and
+// firstBlock[b] is the block holding the smallest such p. A query then
+// only searches [firstBlock[b], firstBlock[b + 1]], a handful of blocks.
+//
+// Threads answer contiguous slices of the queries straight into their
+// input positions, so nothing has to be reordered afterwards.
+
+// Below this the table and the thread start-up cost more than they save
+static constexpr int kBatchMinQueries = 1 << 16;
+
+static vector<long long> answerBatch(const vector<long long>& queries,
+                                     const vector<long long>& prefix,
+                                     const vector<long long>& blockStart,
+                                     unsigned threads)
+{
+    const int k = static_cast<int>(prefix.size()) - 1;
+    const long long total = prefix[k];
+
+    // About four buckets per block, at most 2^20 of them
+    int bits = 0;
+    while (bits < 20 && (1LL << bits) < 4LL * (k + 1)) {
+        bits++;
+    }
+    int shift = 0;
+    while (shift < 62 && (max(total - 1, 0LL) >> shift) >= (1LL << bits)) {
+        shift++;
+    }
+    const size_t buckets = static_cast<size_t>(max(total - 1, 0LL) >> shift) + 1;
+
+    vector<int> firstBlock(buckets + 1);
+    int block = 0;
+    for (size_t b = 0; b <= buckets; b++) {
+        const long long lowest = (static_cast<long long>(b) << shift) + 1;
+        while (block < k && prefix[block] < lowest) {
+            block++;
+        }
+        firstBlock[b] = block;
+    }
+
+    const size_t q = queries.size();
+    vector<long long> answers(q);
+    auto worker = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const long long p = queries[i];
+            if (p > total) {
+                answers[i] = -1;
+                continue;
+            }
+            auto first = prefix.begin();
+            auto last = prefix.end();
+            if (p >= 1) {
+                const size_t b = static_cast<size_t>((p - 1) >> shift);
+                first = prefix.begin() + firstBlock[b];
+                last = prefix.begin() + firstBlock[b + 1] + 1;
+            }
+            const int blockIndex = static_cast<int>(lower_bound(first, last, p) - prefix.begin());
+            const long long before = (blockIndex == 0 ? 0LL : prefix[blockIndex - 1]);
+            answers[i] = blockStart[blockIndex] + (p - before) - 1;
+        }
+    };
+
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(worker, q * t / threads, q * (t + 1) / threads);
+    }
+    worker(0, q / threads);
+    for (auto& th : pool) {
+        th.join();
+    }
+    return answers;
+}
+
+// ----------------------------------------------------
+// Online mode: deletions between queries
+// ----------------------------------------------------
+//
+// Same header (n, k and the k deleted numbers), then q operations:
+//   1 d   delete d (ignored if out of range or already deleted)
+//   2 p   print the p-th remaining number, or -1
+// Rebuilding the prefix array after every deletion would be O(k) each, so
+// this mode keeps the deleted numbers in a RemainingNumbers tree instead:
+// O(log k) per operation, whatever n is.
+static void answerOnline(FastInput& in, FastOutput& out, long long n, const vector<long long>& deleted)
+{
+    RemainingNumbers remaining(n);
+    for (long long d : deleted) {
+        remaining.Delete(d);
+    }
+
+    int q = 0;
+    in.Read(q);
+    while (q--) {
+        int type = 0;
+        long long value = 0;
+        in.Read(type);
+        in.Read(value);
+        if (type == 1) {
+            remaining.Delete(value);
+        } else {
+            out.Write(remaining.Kth(value));
+            out.Write('\n');
+        }
+    }
+}
+
+// Parses the --threads argument; values below 1 mean one thread, as
+// before. Returns false unless the whole argument is a number in int range.
+static bool ParseThreads(const char* arg, unsigned& threads)
+{
+    char* end = nullptr;
+    errno = 0;
+    const long value = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || errno == ERANGE || value > INT_MAX || value < INT_MIN) {
+        return false;
+    }
+    threads = static_cast<unsigned>(max(1L, value));
+    return true;
+}
+
+// Usage: main_templ [--per-query] [--threads N] [--online] < input
+//
+// By default the batch mode kicks in when there are enough queries to pay
+// for the table, and smaller inputs go through the packed BlockIndex
+// (block_index.h); --per-query forces the one-binary-search-per-query path.
+// --online reads the operation format described above answerOnline.
+int main(int argc, char** argv) {
+    bool perQuery = false;
+    bool online = false;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--per-query") == 0) {
+            perQuery = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && ParseThreads(argv[i + 1], threads)) {
+            i++;
+        } else if (strcmp(argv[i], "--online") == 0) {
+            online = true;
+        } else {
+            cerr << "usage: " << argv[0] << " [--per-query] [--threads N] [--online] < input\n";
+            return 2;
+        }
+    }
+
+    // Large inputs: stdin is mapped or read in big chunks, answers are
+    // buffered and written once (see fast_io.h)
+    FastInput in;
+    FastOutput out;
 
     // Read n (up to 10^18) and k (up to 10^5)
-    long long n;
-    int k;
-    cin >> n >> k;
+    long long n = 0;
+    int k = 0;
+    in.Read(n);
+    in.Read(k);
 
     // Read the k deleted numbers (sorted in ascending order)
     vector<long long> deleted(k);
     for (int i = 0; i < k; i++) {
-        cin >> deleted[i];
+        in.Read(deleted[i]);
+    }
+
+    if (online) {
+        answerOnline(in, out, n, deleted);
+        return 0;
     }
 
     // We will create up to k+1 blocks of remaining numbers.
@@ -131,16 +297,41 @@ int main() {
     }
 
     // Now answer q queries
-    int q;
-    cin >> q;
+    int q = 0;
+    in.Read(q);
+
+    if (!perQuery && q >= kBatchMinQueries && static_cast<long long>(q) >= k + 1) {
+        vector<long long> queries(q);
+        for (auto& p : queries) {
+            in.Read(p);
+        }
+        for (long long ans : answerBatch(queries, prefix, blockStart, threads)) {
+            out.Write(ans);
+            out.Write('\n');
+        }
+        return 0;
+    }
+
+    if (!perQuery) {
+        const BlockIndex index(n, deleted);
+        while (q--) {
+            long long p = 0;
+            in.Read(p);
+            out.Write(index.Kth(p));
+            out.Write('\n');
+        }
+        return 0;
+    }
+
     while (q--) {
-        long long p;
-        cin >> p;
+        long long p = 0;
+        in.Read(p);
 
         // If p is larger than total remaining numbers,
         // there's no p-th remaining number
         if (p > prefix[k]) {
-            cout << -1 << "\n";
+            out.Write(-1);
+            out.Write('\n');
             continue;
         }
 
@@ -165,7 +356,8 @@ int main() {
         // So the answer is:
         long long ans = blockStart[blockIndex] + offset - 1;
 
-        cout << ans << "\n";
+        out.Write(ans);
+        out.Write('\n');
     }
 
     return 0;
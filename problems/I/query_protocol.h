@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ----------------------------------------------------
+// Wire format of the query server (server.cpp, loadgen.cpp)
+// ----------------------------------------------------
+//
+// A connection carries a stream of requests and a stream of responses, both
+// in host byte order (the socket is local):
+//
+//   request:   uint32 count, then count x int64 p
+//   response:  count x int64 answer (-1 if there is no p-th number)
+//
+// Responses come back in request order. A client may send further requests
+// before reading earlier responses (pipelining), as long as it keeps reading:
+// the server blocks on a full socket like anyone else.
+//
+// A request with count == 0 or count > kMaxBatch closes the connection.
+
+static constexpr uint32_t kMaxBatch = 1 << 16;
+
+// Loops over short reads; false on EOF or error before `size` bytes arrived.
+inline bool ReadFull(int fd, void* data, size_t size)
+{
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        const ssize_t got = ::read(fd, p, size);
+        if (got > 0) {
+            p += got;
+            size -= static_cast<size_t>(got);
+        } else if (got == 0 || errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool WriteFull(int fd, const void* data, size_t size)
+{
+    const char* p = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t put = ::send(fd, p, size, MSG_NOSIGNAL);
+        if (put > 0) {
+            p += put;
+            size -= static_cast<size_t>(put);
+        } else if (put < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// false if the path does not fit in sun_path
+inline bool MakeAddress(const std::string& path, sockaddr_un& addr)
+{
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+#
+# Usage: ./regression.sh [--quick] [--csv results.csv] [--label L]
+#
+# Builds main.cpp, main_templ.cpp and the tools into $BUILD_DIR
+# (default _regression/), generates the large cases there once, then runs
+# both solvers on the small input_N.txt files and the large cases through
+# run_regression: answers cross-checked, wall time, peak RSS and queries/s
+# per input. --quick keeps to k, q <= 10^6.
+#
+# Pass --csv to append the numbers to a file; --label defaults to the
+# current commit so runs from different commits line up.
+set -euo pipefail
+
+cd "$(dirname "$0")"
+BUILD_DIR=${BUILD_DIR:-_regression}
+CXX=${CXX:-g++}
+
+quick=0
+csv=()
+label=$(git rev-parse --short HEAD 2>/dev/null || echo local)
+while [[ $# -gt 0 ]]; do
+    case "$1" in
+        --quick) quick=1 ;;
+        --csv) csv=(--csv "$2"); shift ;;
+        --label) label="$2"; shift ;;
+        *) echo "usage: $0 [--quick] [--csv results.csv] [--label L]" >&2; exit 2 ;;
+    esac
+    shift
+done
+
+mkdir -p "$BUILD_DIR"
+for src in main main_templ gen_input run_regression; do
+    "$CXX" -O2 -std=c++17 -pthread "$src.cpp" -o "$BUILD_DIR/$src"
+done
+
+# k q pattern
+cases=(
+    "100000 1000000 sparse"
+    "100000 1000000 clustered"
+    "1000000 1000000 prefix"
+)
+if [[ $quick -eq 0 ]]; then
+    cases+=(
+        "100000 10000000 sparse"
+        "10000000 1000000 sparse"
+        "10000000 10000000 clustered"
+        "10000000 10000000 prefix"
+    )
+fi
+
+inputs=(input_*.txt)
+for c in "${cases[@]}"; do
+    read -r k q pattern <<< "$c"
+    file="$BUILD_DIR/large_${pattern}_k${k}_q${q}.txt"
+    if [[ ! -s "$file" ]]; then
+        echo "generating $file" >&2
+        "$BUILD_DIR/gen_input" --k "$k" --q "$q" --pattern "$pattern" > "$file"
+    fi
+    inputs+=("$file")
+done
+
+# main.cpp is the reference: the small cases are checked against their
+# output files, everything else against it
+"$BUILD_DIR/run_regression" "${csv[@]}" --label "$label" \
+    --solver "main=$BUILD_DIR/main" \
+    --solver "main_templ=$BUILD_DIR/main_templ" \
+    "${inputs[@]}"
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// ----------------------------------------------------
+// Numbers 1..n with online deletions
+// ----------------------------------------------------
+//
+// Keeps the deleted numbers in a treap ordered by value, every node knowing
+// the size of its subtree. Nothing depends on n except the range check, so
+// n can be anything up to 10^18.
+//
+// The p-th remaining number: if d_1 < d_2 < ... are the deleted numbers,
+// exactly d_j - j remaining numbers are smaller than d_j, and that count
+// never decreases with j. So we walk down the tree looking for the last d_j
+// with d_j - j < p; those j deleted numbers all lie below the answer, which
+// is therefore p + j.
+//
+// Delete and Kth are O(log k) expected, k = number of deletions so far.
+class RemainingNumbers
+{
+public:
+    explicit RemainingNumbers(long long n)
+        : n_(n)
+        , nodes_(1) // slot 0 is the empty tree
+    {
+    }
+
+    // Deletes d; false if d is outside [1, n] or already deleted.
+    bool Delete(long long d)
+    {
+        if (d < 1 || d > n_ || Contains(d)) {
+            return false;
+        }
+        nodes_.push_back({d, static_cast<uint32_t>(rng_()), 0, 0, 1});
+        root_ = Insert(root_, static_cast<int>(nodes_.size()) - 1);
+        return true;
+    }
+
+    // The p-th smallest number that is still there, or -1 if fewer than p
+    // remain (or p < 1).
+    long long Kth(long long p) const
+    {
+        if (p < 1 || p > Remaining()) {
+            return -1;
+        }
+        long long before = 0; // deleted numbers known to be below the answer
+        int t = root_;
+        while (t != 0) {
+            const Node& node = nodes_[t];
+            const long long rank = before + nodes_[node.left].size + 1;
+            if (node.key - rank < p) {
+                before = rank;
+                t = node.right;
+            } else {
+                t = node.left;
+            }
+        }
+        return p + before;
+    }
+
+    long long Remaining() const { return n_ - nodes_[root_].size; }
+
+private:
+    struct Node {
+        long long key;
+        uint32_t priority;
+        int left;
+        int right;
+        int size;
+    };
+
+    bool Contains(long long d) const
+    {
+        int t = root_;
+        while (t != 0 && nodes_[t].key != d) {
+            t = d < nodes_[t].key ? nodes_[t].left : nodes_[t].right;
+        }
+        return t != 0;
+    }
+
+    void Update(int t) { nodes_[t].size = nodes_[nodes_[t].left].size + nodes_[nodes_[t].right].size + 1; }
+
+    // Goes down by key until the new node outranks the subtree in priority,
+    // then splits that subtree around it: one pass from the root.
+    int Insert(int t, int node)
+    {
+        if (t == 0) {
+            return node;
+        }
+        if (nodes_[node].priority > nodes_[t].priority) {
+            Split(t, nodes_[node].key, nodes_[node].left, nodes_[node].right);
+            Update(node);
+            return node;
+        }
+        if (nodes_[node].key < nodes_[t].key) {
+            nodes_[t].left = Insert(nodes_[t].left, node);
+        } else {
+            nodes_[t].right = Insert(nodes_[t].right, node);
+        }
+        Update(t);
+        return t;
+    }
+
+    // less: keys < d, greater: keys >= d
+    void Split(int t, long long d, int& less, int& greater)
+    {
+        if (t == 0) {
+            less = greater = 0;
+            return;
+        }
+        if (nodes_[t].key < d) {
+            Split(nodes_[t].right, d, nodes_[t].right, greater);
+            less = t;
+        } else {
+            Split(nodes_[t].left, d, less, nodes_[t].left);
+            greater = t;
+        }
+        Update(t);
+    }
+
+    long long n_;
+    std::vector<Node> nodes_;
+    int root_ = 0;
+    std::mt19937 rng_{12345};
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "block_index.h"
+#include "fast_io.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// ----------------------------------------------------
+// Reusable solver for "p-th remaining number" queries
+// ----------------------------------------------------
+//
+// Owns a deleted set and answers queries against it for as long as it
+// lives: build it once, then call Answer / AnswerBatch from any number of
+// threads (both are const and touch no shared mutable state).
+//
+// Unlike the one-shot solvers it does not trust its input: the deleted
+// numbers may come unsorted, repeated or outside [1, n].
+class RemainingSolver
+{
+public:
+    RemainingSolver(long long n, std::vector<long long> deleted)
+        : n_(n)
+        , k_(Normalize(n, deleted))
+        , index_(n, deleted)
+    {
+    }
+
+    // Reads "n k d_1 ... d_k" (the header of the problem input). Missing
+    // numbers read as zero and are dropped as out of range.
+    static RemainingSolver Load(FastInput& in)
+    {
+        long long n = 0;
+        long long k = 0;
+        in.Read(n);
+        in.Read(k);
+        std::vector<long long> deleted(static_cast<size_t>(std::max(k, 0LL)));
+        for (auto& d : deleted) {
+            in.Read(d);
+        }
+        return RemainingSolver(n, std::move(deleted));
+    }
+
+    // The p-th remaining number, or -1 if fewer than p remain.
+    long long Answer(long long p) const { return index_.Kth(p); }
+
+    void AnswerBatch(const long long* p, long long* out, size_t count) const { index_.KthBatch(p, out, count); }
+
+    long long N() const { return n_; }
+    // Distinct deleted numbers within [1, n]
+    size_t Deleted() const { return k_; }
+
+private:
+    static size_t Normalize(long long n, std::vector<long long>& deleted)
+    {
+        deleted.erase(std::remove_if(deleted.begin(), deleted.end(), [n](long long d) { return d < 1 || d > n; }),
+                      deleted.end());
+        std::sort(deleted.begin(), deleted.end());
+        deleted.erase(std::unique(deleted.begin(), deleted.end()), deleted.end());
+        return deleted.size();
+    }
+
+    long long n_;
+    size_t k_;
+    BlockIndex index_;
+};
@@ -0,0 +1,189 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// g++ -O2 -std=c++17 run_regression.cpp -o run_regression
+//
+// Usage: run_regression [--csv results.csv] [--label L] --solver name=path...
+//                       input.txt...
+//
+// Runs every solver on every input (stdin from the file, stdout to a
+// scratch file next to it) and prints wall time, peak RSS and queries per
+// second. The first solver is the reference: any other solver whose
+// answers differ from it is reported as MISMATCH. If the input has an
+// output_N.txt partner, the reference itself is checked against it too.
+// Answers are compared as whitespace-separated tokens, so a missing
+// trailing newline does not count.
+//
+// With --csv, one line per run is appended (label, input, solver, seconds,
+// peak KB, queries/s, status), so results from different commits can be
+// lined up. The exit code is 1 if anything mismatched or crashed.
+
+struct Solver {
+    string name;
+    string path;
+};
+
+struct Run {
+    double seconds = 0;
+    long peakKb = 0;
+    bool ok = false;
+};
+
+// Runs path < input > output in a child and measures it. Peak RSS comes
+// from wait4, which reports the child alone.
+static Run runSolver(const string& path, const string& input, const string& output)
+{
+    Run run;
+    const auto t0 = chrono::steady_clock::now();
+    const pid_t pid = fork();
+    if (pid == 0) {
+        const int in = open(input.c_str(), O_RDONLY);
+        const int out = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (in < 0 || out < 0 || dup2(in, STDIN_FILENO) < 0 || dup2(out, STDOUT_FILENO) < 0) {
+            _exit(127);
+        }
+        execl(path.c_str(), path.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    if (pid < 0) {
+        return run;
+    }
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid) {
+        return run;
+    }
+    run.seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    run.peakKb = usage.ru_maxrss;
+    run.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    return run;
+}
+
+// Token-by-token comparison; streams both files instead of loading them
+static bool sameTokens(const string& a, const string& b)
+{
+    ifstream fa(a);
+    ifstream fb(b);
+    string ta;
+    string tb;
+    for (;;) {
+        const bool moreA = static_cast<bool>(fa >> ta);
+        const bool moreB = static_cast<bool>(fb >> tb);
+        if (moreA != moreB) {
+            return false;
+        }
+        if (!moreA) {
+            return true;
+        }
+        if (ta != tb) {
+            return false;
+        }
+    }
+}
+
+// One answer per query
+static long long countTokens(const string& path)
+{
+    ifstream file(path);
+    return distance(istream_iterator<string>(file), istream_iterator<string>());
+}
+
+// input_7.txt -> output_7.txt; empty if the name does not follow the pattern
+static string expectedOutput(const string& input)
+{
+    const size_t slash = input.find_last_of('/');
+    const size_t base = (slash == string::npos ? 0 : slash + 1);
+    if (input.compare(base, 6, "input_") != 0) {
+        return "";
+    }
+    string expected = input;
+    expected.replace(base, 6, "output_");
+    return ifstream(expected).good() ? expected : "";
+}
+
+int main(int argc, char** argv) {
+    vector<Solver> solvers;
+    vector<string> inputs;
+    string csvPath;
+    string label = "run";
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--solver") == 0 && hasValue) {
+            const string spec = argv[++i];
+            const size_t eq = spec.find('=');
+            if (eq == string::npos) {
+                solvers.push_back({spec, spec});
+            } else {
+                solvers.push_back({spec.substr(0, eq), spec.substr(eq + 1)});
+            }
+        } else if (strcmp(argv[i], "--csv") == 0 && hasValue) {
+            csvPath = argv[++i];
+        } else if (strcmp(argv[i], "--label") == 0 && hasValue) {
+            label = argv[++i];
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (solvers.empty() || inputs.empty()) {
+        cerr << "usage: " << argv[0] << " [--csv results.csv] [--label L] --solver name=path... input.txt...\n";
+        return 2;
+    }
+
+    ofstream csv;
+    if (!csvPath.empty()) {
+        csv.open(csvPath, ios::app);
+    }
+
+    bool allOk = true;
+    printf("%-40s %-12s %9s %10s %14s  %s\n", "input", "solver", "wall s", "peak MB", "queries/s", "status");
+    for (const string& input : inputs) {
+        const string expected = expectedOutput(input);
+        const string name = input.substr(input.find_last_of('/') + 1);
+        const string reference = input + "." + solvers[0].name + ".out";
+        long long queries = 0;
+
+        for (size_t s = 0; s < solvers.size(); s++) {
+            const string output = input + "." + solvers[s].name + ".out";
+            const Run run = runSolver(solvers[s].path, input, output);
+
+            string status = "ok";
+            if (!run.ok) {
+                status = "CRASHED";
+            } else if (s == 0 && !expected.empty() && !sameTokens(output, expected)) {
+                status = "WRONG (vs " + expected + ")";
+            } else if (s > 0 && !sameTokens(output, reference)) {
+                status = "MISMATCH (vs " + solvers[0].name + ")";
+            }
+            if (s == 0) {
+                queries = countTokens(output);
+            } else {
+                unlink(output.c_str());
+            }
+            allOk = allOk && status == "ok";
+
+            const double qps = run.seconds > 0 ? static_cast<double>(queries) / run.seconds : 0;
+            printf("%-40s %-12s %9.3f %10.1f %14.0f  %s\n", name.c_str(), solvers[s].name.c_str(), run.seconds,
+                   static_cast<double>(run.peakKb) / 1024.0, qps, status.c_str());
+            fflush(stdout);
+            if (csv.is_open()) {
+                csv << label << ',' << input << ',' << solvers[s].name << ',' << run.seconds << ',' << run.peakKb
+                    << ',' << static_cast<long long>(qps) << ',' << status << '\n';
+            }
+        }
+        unlink(reference.c_str());
+    }
+    return allOk ? 0 : 1;
+}
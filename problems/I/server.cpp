@@ -0,0 +1,233 @@
+#include "fast_io.h"
+#include "query_protocol.h"
+#include "remaining_solver.h"
+
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// g++ -O2 -std=c++17 server.cpp -o server -pthread
+//
+// Usage: server <socket-path> [--threads N] < deleted-set
+//
+// Loads "n k d_1 ... d_k" once, then answers p-queries from any number of
+// local clients (wire format in query_protocol.h) until SIGINT / SIGTERM.
+//
+// One acceptor thread queues new connections; a pool of N workers takes
+// them one at a time and serves each until the client hangs up. A worker
+// reads a request, answers the whole batch with AnswerBatch and writes the
+// response, so pipelined requests simply wait in the socket buffer while
+// the previous one is answered. With more clients than workers, the extra
+// connections wait in the queue.
+//
+// SIGINT and SIGTERM are blocked in every thread and read from a signalfd
+// that the acceptor polls together with the listener, so a signal that
+// arrives while the acceptor is between two accepts is not lost.
+
+class ConnectionQueue
+{
+public:
+    void Push(int fd)
+    {
+        {
+            lock_guard<mutex> lock(mutex_);
+            pending_.push_back(fd);
+        }
+        ready_.notify_one();
+    }
+
+    // -1 once Close() has been called and nothing is left
+    int Pop()
+    {
+        unique_lock<mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return closed_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return -1;
+        }
+        const int fd = pending_.front();
+        pending_.pop_front();
+        active_.insert(fd);
+        return fd;
+    }
+
+    void Done(int fd)
+    {
+        lock_guard<mutex> lock(mutex_);
+        active_.erase(fd);
+        ::close(fd);
+    }
+
+    // Wakes idle workers and cuts off the connections being served, so
+    // blocked reads return and every worker can be joined.
+    void Close()
+    {
+        {
+            lock_guard<mutex> lock(mutex_);
+            closed_ = true;
+            for (int fd : pending_) {
+                ::close(fd);
+            }
+            pending_.clear();
+            for (int fd : active_) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+        ready_.notify_all();
+    }
+
+private:
+    mutex mutex_;
+    condition_variable ready_;
+    deque<int> pending_;
+    set<int> active_;
+    bool closed_ = false;
+};
+
+static void serve(const RemainingSolver& solver, int fd)
+{
+    vector<long long> queries;
+    vector<long long> answers;
+    for (;;) {
+        uint32_t count = 0;
+        if (!ReadFull(fd, &count, sizeof(count)) || count == 0 || count > kMaxBatch) {
+            return;
+        }
+        queries.resize(count);
+        answers.resize(count);
+        if (!ReadFull(fd, queries.data(), count * sizeof(long long))) {
+            return;
+        }
+        solver.AnswerBatch(queries.data(), answers.data(), count);
+        if (!WriteFull(fd, answers.data(), count * sizeof(long long))) {
+            return;
+        }
+    }
+}
+
+// Parses the --threads argument; values below 1 mean one thread, as
+// before. Returns false unless the whole argument is a number in int range.
+static bool ParseThreads(const char* arg, unsigned& threads)
+{
+    char* end = nullptr;
+    errno = 0;
+    const long value = strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || errno == ERANGE || value > INT_MAX || value < INT_MIN) {
+        return false;
+    }
+    threads = static_cast<unsigned>(max(1L, value));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    string path;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            if (!ParseThreads(argv[++i], threads)) {
+                path.clear();
+                break;
+            }
+        } else if (path.empty() && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    sockaddr_un addr;
+    if (path.empty() || !MakeAddress(path, addr)) {
+        cerr << "usage: " << argv[0] << " <socket-path> [--threads N] < deleted-set\n";
+        return 2;
+    }
+
+    const RemainingSolver solver = [] {
+        FastInput in;
+        return RemainingSolver::Load(in);
+    }();
+
+    // Non-blocking: poll() can report a connection that is gone again by
+    // the time accept4() runs
+    const int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    ::unlink(path.c_str());
+    if (listener < 0 || ::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(listener, SOMAXCONN) != 0) {
+        cerr << "server: cannot listen on " << path << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+
+    // Blocked before any worker starts, so every thread inherits the mask
+    // and the signals stay pending for the signalfd
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    const int signal_fd = ::signalfd(-1, &signals, SFD_CLOEXEC);
+    if (signal_fd < 0) {
+        cerr << "server: signalfd: " << strerror(errno) << "\n";
+        return 1;
+    }
+
+    cerr << "server: n = " << solver.N() << ", " << solver.Deleted() << " deleted, " << threads
+         << " workers, listening on " << path << "\n";
+
+    ConnectionQueue queue;
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (int fd; (fd = queue.Pop()) >= 0;) {
+                serve(solver, fd);
+                queue.Done(fd);
+            }
+        });
+    }
+
+    pollfd fds[2] = {{listener, POLLIN, 0}, {signal_fd, POLLIN, 0}};
+    for (;;) {
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cerr << "server: poll: " << strerror(errno) << "\n";
+            break;
+        }
+        if (fds[1].revents != 0) {
+            break;
+        }
+        const int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd >= 0) {
+            queue.Push(fd);
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED) {
+            cerr << "server: accept: " << strerror(errno) << "\n";
+            break;
+        }
+    }
+
+    queue.Close();
+    for (auto& w : workers) {
+        w.join();
+    }
+    ::close(signal_fd);
+    ::close(listener);
+    ::unlink(path.c_str());
+    return 0;
+}